@@ -1,6 +1,12 @@
 #include <iostream>
 #include <variant>
 #include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <mutex>
 
 struct False;
 struct True;
@@ -10,24 +16,114 @@ struct Binary;
 
 using Formula = std::variant<False, True, Atom, Not, Binary>;
 using FormulaPtr = std::shared_ptr<Formula>;
-using Valuation = std::map<std::string, bool>;
+using AtomId = uint32_t;
+using Valuation = std::map<AtomId, bool>;
 
 struct False {};
 struct True {};
-struct Atom { std::string name; };
+struct Atom { AtomId id; };
 struct Not { FormulaPtr subformula; };
 struct Binary {
    enum Type { And, Or, Impl, Eq } type;
    FormulaPtr left, right;
 };
 
-FormulaPtr ptr(Formula f) { return std::make_shared<Formula>(f); }
+// Tabela simbola: svako ime atoma se cuva jednom, a formule, literali,
+// valuacije i klauze koriste gust 32-bitni identifikator (0, 1, 2, ... po
+// redu prvog pojavljivanja). Ime se trazi samo pri ucitavanju i ispisu.
+struct SymbolTable {
+   std::vector<std::string> names;
+   std::unordered_map<std::string, AtomId> ids;
+};
+
+SymbolTable& symbols() {
+   static SymbolTable table;
+   return table;
+}
+
+AtomId intern(const std::string& name) {
+   SymbolTable& table = symbols();
+   auto [it, inserted] = table.ids.emplace(name, table.names.size());
+   if(inserted)
+      table.names.push_back(name);
+   return it->second;
+}
+
+const std::string& atomName(AtomId atom) {
+   return symbols().names[atom];
+}
+
+// Kljuc jedinstvene tabele: vrsta cvora (za Binary i veznik), podformule i
+// atom. Podformule su vec jedinstvene, pa se porede kao pokazivaci.
+struct FormulaKey {
+   int kind;
+   const Formula* left;
+   const Formula* right;
+   AtomId atom;
+
+   bool operator==(const FormulaKey& k) const {
+      return kind == k.kind && left == k.left && right == k.right && atom == k.atom;
+   }
+};
+
+struct FormulaKeyHash {
+   size_t operator()(const FormulaKey& k) const {
+      size_t h = (size_t)k.kind << 32 | k.atom;
+      h = h * 0x9e3779b97f4a7c15 ^ std::hash<const Formula*>()(k.left);
+      return h * 0x9e3779b97f4a7c15 ^ std::hash<const Formula*>()(k.right);
+   }
+};
+
+FormulaKey key(const Formula& f) {
+   if(std::holds_alternative<Atom>(f))
+      return {2, nullptr, nullptr, std::get<Atom>(f).id};
+   if(std::holds_alternative<Not>(f))
+      return {3, std::get<Not>(f).subformula.get(), nullptr, {}};
+   if(std::holds_alternative<Binary>(f)) {
+      const Binary& b = std::get<Binary>(f);
+      return {4 + b.type, b.left.get(), b.right.get(), {}};
+   }
+   return {(int)f.index(), nullptr, nullptr, {}};
+}
+
+// Jedinstvena tabela cvorova. Tabela cuva slabe pokazivace da ne bi
+// zadrzavala formule koje se vise ne koriste, a istekli ulazi se izbacuju
+// kad tabela dostigne dvostruku velicinu. Deljena je izmedju niti, pa je
+// cuva mutex.
+struct UniqueTable {
+   std::unordered_map<FormulaKey, std::weak_ptr<Formula>, FormulaKeyHash> nodes;
+   size_t purgeAt = 1024;
+   std::mutex mutex;
+};
+
+UniqueTable& uniqueTable() {
+   static UniqueTable table;
+   return table;
+}
+
+// Formule se prave samo kroz ptr, koji za strukturno jednake formule vraca
+// isti cvor, pa su zajednicke podformule zapamcene jednom.
+FormulaPtr ptr(Formula f) {
+   UniqueTable& table = uniqueTable();
+   std::lock_guard<std::mutex> lock(table.mutex);
+   std::weak_ptr<Formula>& slot = table.nodes[key(f)];
+   if(FormulaPtr existing = slot.lock())
+      return existing;
+   FormulaPtr node = std::make_shared<Formula>(std::move(f));
+   slot = node;
+   if(table.nodes.size() >= table.purgeAt) {
+      for(auto it = begin(table.nodes); it != end(table.nodes); )
+         it = it->second.expired() ? table.nodes.erase(it) : std::next(it);
+      table.purgeAt = std::max<size_t>(1024, 2 * table.nodes.size());
+   }
+   return node;
+}
 
 template <typename T>
 bool is(const FormulaPtr& f) { return std::holds_alternative<T>(*f); }
 
 template <typename T>
-T as (const FormulaPtr& f) { return std::get<T>(*f); }
+const T& as(const FormulaPtr& f) { return std::get<T>(*f); }
 
 int complexity(const FormulaPtr& f) {
    if(is<False>(f)) {
@@ -51,7 +147,7 @@ int complexity(const FormulaPtr& f) {
 std::string print(const FormulaPtr& f) {
    if(is<False>(f)) return "F";
    if(is<True>(f)) return "T";
-   if(is<Atom>(f)) return as<Atom>(f).name;
+   if(is<Atom>(f)) return atomName(as<Atom>(f).id);
    if(is<Not>(f)) return "~" + print(as<Not>(f).subformula);
    if(is<Binary>(f)) {
       std::string sign;
@@ -72,7 +168,7 @@ bool evaluate(const FormulaPtr& f, Valuation& v) {
    if(is<True>(f))
       return true;
    if(is<Atom>(f))
-      return v[as<Atom>(f).name];
+      return v[as<Atom>(f).id];
    if(is<Not>(f))
       return !evaluate(as<Not>(f).subformula, v);
    if(is<Binary>(f)) {
@@ -88,34 +184,18 @@ bool evaluate(const FormulaPtr& f, Valuation& v) {
    return false;
 }
 
+// Strukturno jednake formule su isti cvor (videti ptr).
 bool equal(const FormulaPtr& f, const FormulaPtr& g) {
-   if(f->index() != g->index()) {
-      return false;
-   }
-
-   if(is<False>(f) || is<True>(f))
-      return true;
-
-   if(is<Atom>(f))
-      return as<Atom>(f).name == as<Atom>(g).name;
-
-   if(is<Not>(f))
-      return equal(as<Not>(f).subformula, as<Not>(g).subformula);
-
-   if(is<Binary>(f)) {
-      return as<Binary>(f).type == as<Binary>(g).type && equal(as<Binary>(f).left, as<Binary>(g).left) && equal(as<Binary>(f).right, as<Binary>(g).right);
-   }
-
-   return false;
+   return f == g;
 }
 
 int main() {
-   FormulaPtr p = ptr(Atom{"p"});
-   FormulaPtr q = ptr(Atom{"q"});
+   FormulaPtr p = ptr(Atom{intern("p")});
+   FormulaPtr q = ptr(Atom{intern("q")});
    FormulaPtr p_and_q = ptr(Binary{Binary::And, p, q});
    std::cout << complexity(p_and_q) << std::endl;
    std::cout << print(p_and_q) << std::endl;
-   Valuation v = {{"p", true}, {"q", false}};
+   Valuation v = {{intern("p"), true}, {intern("q"), false}};
    std::cout << (evaluate(p_and_q, v) ? "True" : "False") << std::endl;
    return 0;
 }
@@ -0,0 +1,64 @@
+// Testovi: main.cpp se ukljucuje sa preimenovanom funkcijom main.
+// Prevodjenje: g++ -std=c++17 -O2 -pthread test.cpp -o test
+#define main formulaMain
+#include "main.cpp"
+#undef main
+#include <thread>
+
+int failures = 0;
+
+void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "OK    " : "GRESKA") << " " << name << std::endl;
+    if(!condition)
+        failures++;
+}
+
+// (p /\ q) => ~r, svaki put iz novih cvorova.
+FormulaPtr example() {
+    FormulaPtr p = ptr(Atom{intern("p")});
+    FormulaPtr q = ptr(Atom{intern("q")});
+    FormulaPtr r = ptr(Atom{intern("r")});
+    return ptr(Binary{Binary::Impl, ptr(Binary{Binary::And, p, q}), ptr(Not{r})});
+}
+
+// Strukturno jednake formule su isti cvor, a razlicite nisu; to vazi i
+// kada cvorove istovremeno prave vise niti.
+void sharedNodes() {
+    FormulaPtr f = example();
+    FormulaPtr p = ptr(Atom{intern("p")});
+    FormulaPtr q = ptr(Atom{intern("q")});
+    check(example() == f && equal(example(), f), "ptr: strukturno jednake formule su isti cvor");
+    check(ptr(Binary{Binary::And, p, q}) != ptr(Binary{Binary::And, q, p})
+          && ptr(Binary{Binary::And, p, q}) != ptr(Binary{Binary::Or, p, q})
+          && ptr(Not{p}) != ptr(Not{q}) && ptr(True{}) == ptr(True{}),
+          "ptr: razlicite formule su razliciti cvorovi");
+    std::vector<FormulaPtr> built(4);
+    std::vector<std::thread> threads;
+    for(size_t i = 0; i < built.size(); i++)
+        threads.emplace_back([&built, i] {
+            for(int j = 0; j < 2000; j++)
+                built[i] = ptr(Not{ptr(Not{ptr(Atom{AtomId(1000 + j % 50)})})});
+        });
+    for(std::thread& thread : threads)
+        thread.join();
+    bool same = true;
+    for(const FormulaPtr& g : built)
+        same = same && g == built[0];
+    check(same, "ptr: niti dobijaju isti cvor");
+}
+
+// Istekli ulazi se izbacuju, pa tabela ne raste sa brojem formula koje su
+// napravljene i odbacene, a zive formule ostaju u njoj.
+void purgeExpired() {
+    FormulaPtr f = example();
+    for(AtomId atom = 0; atom < 100000; atom++)
+        ptr(Not{ptr(Atom{atom + 2000})});
+    check(uniqueTable().nodes.size() < 4096, "ptr: istekli ulazi su izbaceni");
+    check(example() == f, "ptr: zive formule ostaju u tabeli");
+}
+
+int main() {
+    sharedNodes();
+    purgeExpired();
+    return failures > 0;
+}
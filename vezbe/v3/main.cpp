@@ -1,7 +1,17 @@
 #include <iostream>
 #include <variant>
 #include <map>
+#include <memory>
+#include <unordered_map>
+#include <optional>
+#include <cstdint>
 #include <set>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <vector>
 
 struct False;
@@ -13,14 +23,15 @@ struct Literal;
 
 using Formula = std::variant<False, True, Atom, Not, Binary>;
 using FormulaPtr = std::shared_ptr<Formula>;
-using Valuation = std::map<std::string, bool>;
-using AtomSet = std::set<std::string>;
+using AtomId = uint32_t;
+using Valuation = std::map<AtomId, bool>;
+using AtomSet = std::set<AtomId>;
 using Clause = std::vector<Literal>;
 using NormalForm = std::vector<Clause>;
 
 struct False {};
 struct True {};
-struct Atom { std::string name; };
+struct Atom { AtomId id; };
 struct Not { FormulaPtr subformula; };
 struct Binary {
    enum Type { And, Or, Impl, Eq } type;
@@ -28,16 +39,105 @@ struct Binary {
 };
 struct Literal {
     bool pos;
-    std::string name;
+    AtomId atom;
 };
 
-FormulaPtr ptr(Formula f) { return std::make_shared<Formula>(f); }
+// Tabela simbola: svako ime atoma se cuva jednom, a formule, literali,
+// valuacije i klauze koriste gust 32-bitni identifikator (0, 1, 2, ... po
+// redu prvog pojavljivanja). Ime se trazi samo pri ucitavanju i ispisu.
+struct SymbolTable {
+   std::vector<std::string> names;
+   std::unordered_map<std::string, AtomId> ids;
+};
+
+SymbolTable& symbols() {
+   static SymbolTable table;
+   return table;
+}
+
+AtomId intern(const std::string& name) {
+   SymbolTable& table = symbols();
+   auto [it, inserted] = table.ids.emplace(name, table.names.size());
+   if(inserted)
+      table.names.push_back(name);
+   return it->second;
+}
+
+const std::string& atomName(AtomId atom) {
+   return symbols().names[atom];
+}
+
+// Kljuc jedinstvene tabele: vrsta cvora (za Binary i veznik), podformule i
+// atom. Podformule su vec jedinstvene, pa se porede kao pokazivaci.
+struct FormulaKey {
+   int kind;
+   const Formula* left;
+   const Formula* right;
+   AtomId atom;
+
+   bool operator==(const FormulaKey& k) const {
+      return kind == k.kind && left == k.left && right == k.right && atom == k.atom;
+   }
+};
+
+struct FormulaKeyHash {
+   size_t operator()(const FormulaKey& k) const {
+      size_t h = (size_t)k.kind << 32 | k.atom;
+      h = h * 0x9e3779b97f4a7c15 ^ std::hash<const Formula*>()(k.left);
+      return h * 0x9e3779b97f4a7c15 ^ std::hash<const Formula*>()(k.right);
+   }
+};
+
+FormulaKey key(const Formula& f) {
+   if(std::holds_alternative<Atom>(f))
+      return {2, nullptr, nullptr, std::get<Atom>(f).id};
+   if(std::holds_alternative<Not>(f))
+      return {3, std::get<Not>(f).subformula.get(), nullptr, {}};
+   if(std::holds_alternative<Binary>(f)) {
+      const Binary& b = std::get<Binary>(f);
+      return {4 + b.type, b.left.get(), b.right.get(), {}};
+   }
+   return {(int)f.index(), nullptr, nullptr, {}};
+}
+
+// Jedinstvena tabela cvorova. Tabela cuva slabe pokazivace da ne bi
+// zadrzavala formule koje se vise ne koriste, a istekli ulazi se izbacuju
+// kad tabela dostigne dvostruku velicinu. Deljena je izmedju niti, pa je
+// cuva mutex.
+struct UniqueTable {
+   std::unordered_map<FormulaKey, std::weak_ptr<Formula>, FormulaKeyHash> nodes;
+   size_t purgeAt = 1024;
+   std::mutex mutex;
+};
+
+UniqueTable& uniqueTable() {
+   static UniqueTable table;
+   return table;
+}
+
+// Formule se prave samo kroz ptr, koji za strukturno jednake formule vraca
+// isti cvor, pa su zajednicke podformule zapamcene jednom.
+FormulaPtr ptr(Formula f) {
+   UniqueTable& table = uniqueTable();
+   std::lock_guard<std::mutex> lock(table.mutex);
+   std::weak_ptr<Formula>& slot = table.nodes[key(f)];
+   if(FormulaPtr existing = slot.lock())
+      return existing;
+   FormulaPtr node = std::make_shared<Formula>(std::move(f));
+   slot = node;
+   if(table.nodes.size() >= table.purgeAt) {
+      for(auto it = begin(table.nodes); it != end(table.nodes); )
+         it = it->second.expired() ? table.nodes.erase(it) : std::next(it);
+      table.purgeAt = std::max<size_t>(1024, 2 * table.nodes.size());
+   }
+   return node;
+}
 
 template <typename T>
 bool is(const FormulaPtr& f) { return std::holds_alternative<T>(*f); }
 
 template <typename T>
-T as (const FormulaPtr& f) { return std::get<T>(*f); }
+const T& as(const FormulaPtr& f) { return std::get<T>(*f); }
 
 int complexity(const FormulaPtr& f) {
    if(is<False>(f)) {
@@ -61,7 +161,7 @@ int complexity(const FormulaPtr& f) {
 std::string print(const FormulaPtr& f) {
    if(is<False>(f)) return "F";
    if(is<True>(f)) return "T";
-   if(is<Atom>(f)) return as<Atom>(f).name;
+   if(is<Atom>(f)) return atomName(as<Atom>(f).id);
    if(is<Not>(f)) return "~" + print(as<Not>(f).subformula);
    if(is<Binary>(f)) {
       std::string sign;
@@ -82,7 +182,7 @@ bool evaluate(const FormulaPtr& f, Valuation& v) {
    if(is<True>(f))
       return true;
    if(is<Atom>(f))
-      return v[as<Atom>(f).name];
+      return v[as<Atom>(f).id];
    if(is<Not>(f))
       return !evaluate(as<Not>(f).subformula, v);
    if(is<Binary>(f)) {
@@ -98,25 +198,9 @@ bool evaluate(const FormulaPtr& f, Valuation& v) {
    return false;
 }
 
+// Strukturno jednake formule su isti cvor (videti ptr).
 bool equal(const FormulaPtr& f, const FormulaPtr& g) {
-   if(f->index() != g->index()) {
-      return false;
-   }
-
-   if(is<False>(f) || is<True>(f))
-      return true;
-
-   if(is<Atom>(f))
-      return as<Atom>(f).name == as<Atom>(g).name;
-
-   if(is<Not>(f))
-      return equal(as<Not>(f).subformula, as<Not>(g).subformula);
-
-   if(is<Binary>(f)) {
-      return as<Binary>(f).type == as<Binary>(g).type && equal(as<Binary>(f).left, as<Binary>(g).left) && equal(as<Binary>(f).right, as<Binary>(g).right);
-   }
-
-   return false;
+   return f == g;
 }
 
 FormulaPtr substitute(const FormulaPtr& f, const FormulaPtr& what, const FormulaPtr& with) {
@@ -139,7 +223,7 @@ FormulaPtr substitute(const FormulaPtr& f, const FormulaPtr& what, const Formula
 
 void getAtoms(const FormulaPtr& f, AtomSet& atoms) {
     if(is<Atom>(f))
-        atoms.insert(as<Atom>(f).name);
+        atoms.insert(as<Atom>(f).id);
     else if(is<Not>(f))
         getAtoms(as<Not>(f).subformula, atoms);
     else if(is<Binary>(f)) {
@@ -167,36 +251,338 @@ void print(Valuation& v) {
         std::cout << value << ' ';
 }
 
-void table(const FormulaPtr& f) {
+// Formula prevedena u program nad gustim indeksima atoma. Prvih
+// atoms.size() slotova su vrednosti atoma (0 ili 1, atomi po imenu), a
+// svaka instrukcija je jedan razlicit cvor formule i racuna sledeci slot iz
+// slotova svojih podformula. Zajednicke podformule su isti cvor, pa se
+// racunaju jednom. Veznik je zapisan kao tablica istinitosti od 4 bita
+// (bit 2l + r je vrednost za vrednosti podformula l i r), pa je
+// izvrsavanje jedna petlja bez grananja, rekurzije, mapa i brojaca
+// referenci.
+struct Program {
+    enum Op : uint8_t { Zero = 0, Neg = 3, And = 8, Eq = 9, Impl = 11, Or = 14, One = 15 };
+    struct Instruction {
+        uint32_t left, right;
+        Op op;
+    };
+    std::vector<AtomId> atoms;
+    std::vector<Instruction> code;
+    uint32_t result = 0;
+};
+
+uint32_t compile(const FormulaPtr& f, Program& p, std::unordered_map<AtomId, uint32_t>& index,
+                 std::unordered_map<const Formula*, uint32_t>& done) {
+    if(is<Atom>(f))
+        return index[as<Atom>(f).id];
+    auto it = done.find(f.get());
+    if(it != end(done))
+        return it->second;
+    Program::Instruction instruction{0, 0, Program::Zero};
+    if(is<True>(f))
+        instruction.op = Program::One;
+    else if(is<Not>(f)) {
+        uint32_t sub = compile(as<Not>(f).subformula, p, index, done);
+        instruction = {sub, sub, Program::Neg};
+    }
+    else if(is<Binary>(f)) {
+        const Program::Op ops[] = {Program::And, Program::Or, Program::Impl, Program::Eq};
+        const Binary& b = as<Binary>(f);
+        uint32_t left = compile(b.left, p, index, done);
+        uint32_t right = compile(b.right, p, index, done);
+        instruction = {left, right, ops[b.type]};
+    }
+    p.code.push_back(instruction);
+    return done[f.get()] = p.atoms.size() + p.code.size() - 1;
+}
+
+Program compile(const FormulaPtr& f) {
+    Program p;
     AtomSet atoms;
     getAtoms(f, atoms);
+    // Identifikatori prate redosled ucitavanja, a kolone tablice su po imenu.
+    p.atoms.assign(begin(atoms), end(atoms));
+    std::sort(begin(p.atoms), end(p.atoms), [](AtomId a, AtomId b) { return atomName(a) < atomName(b); });
+    std::unordered_map<AtomId, uint32_t> index;
+    for(size_t i = 0; i < p.atoms.size(); i++)
+        index[p.atoms[i]] = i;
+    std::unordered_map<const Formula*, uint32_t> done;
+    p.result = compile(f, p, index, done);
+    return p;
+}
 
-    Valuation v;
-    for(const std::string& atom : atoms) {
-        v[atom] = false;
-        std::cout << atom << ' ';
+// Valuacija programa: i-ti bajt je vrednost atoma atoms[i] (0 ili 1).
+std::vector<uint8_t> valuation(const Program& p, Valuation& v) {
+    std::vector<uint8_t> values(p.atoms.size());
+    for(size_t i = 0; i < p.atoms.size(); i++)
+        values[i] = v[p.atoms[i]];
+    return values;
+}
+
+// Sledeca valuacija programa, kao next(Valuation&).
+bool next(std::vector<uint8_t>& values) {
+    for(uint8_t& value : values) {
+        value = !value;
+        if(value)
+            return true;
     }
-    std::cout << std::endl;
+    return false;
+}
 
-    do {
-        print(v);
-        std::cout << "| " << evaluate(f, v) << std::endl;
-    } while(next(v));
+// Vrednost formule u jednoj valuaciji. Medjurezultati su u baferu niti, a
+// Program se ne menja, pa isti program moze da se izvrsava iz vise niti.
+bool evaluate(const Program& p, const std::vector<uint8_t>& values) {
+    thread_local std::vector<uint8_t> slots;
+    slots.resize(p.atoms.size() + p.code.size());
+    uint8_t* s = slots.data();
+    std::copy(begin(values), end(values), s);
+    uint8_t* out = s + p.atoms.size();
+    // Upisi u uint8_t mogu da se preklapaju sa bilo cim, pa se granice
+    // programa citaju jednom, pre petlje.
+    const Program::Instruction* instruction = p.code.data();
+    const Program::Instruction* last = instruction + p.code.size();
+    for(; instruction != last; instruction++)
+        *out++ = instruction->op >> (2 * s[instruction->left] + s[instruction->right]) & 1;
+    return s[p.result];
 }
 
-std::optional<Valuation> isSatisfiable(const FormulaPtr& f) {
-    AtomSet atoms;
-    getAtoms(f, atoms);
+// Bit-paralelno izracunavanje: slot je kolona istinitosne tablice za
+// 64 * Words uzastopnih vrsta (bit k reci w je vrsta first + 64w + k), pa
+// jedan prolaz kroz program racuna toliko vrsta odjednom. Atom i u vrsti r
+// ima vrednost bita i broja r, kao kod next(Valuation&). Veznik se primenjuje
+// preko maski iz tablice istinitosti, bez grananja.
+const uint64_t atomColumns[6] = {
+    0xAAAAAAAAAAAAAAAA, 0xCCCCCCCCCCCCCCCC, 0xF0F0F0F0F0F0F0F0,
+    0xFF00FF00FF00FF00, 0xFFFF0000FFFF0000, 0xFFFFFFFF00000000
+};
+
+// Ceo slot je jedan vektor od 1, 4 ili 8 reci, pa prevodilac za AVX2 i
+// AVX-512 koristi jednu instrukciju po operaciji. Slotovi moraju biti
+// poravnati na 64 bajta.
+typedef uint64_t Block64 __attribute__((vector_size(8)));
+typedef uint64_t Block256 __attribute__((vector_size(32)));
+typedef uint64_t Block512 __attribute__((vector_size(64)));
+
+template<typename Block>
+inline __attribute__((always_inline))
+void evaluateRows(const Program& p, uint64_t first, uint64_t* result, uint64_t* slots) {
+    const int words = sizeof(Block) / 8;
+    for(size_t i = 0; i < p.atoms.size(); i++)
+        for(int w = 0; w < words; w++)
+            slots[i * words + w] = i < 6 ? atomColumns[i] : -((first + 64 * w) >> i & 1);
+    Block* s = (Block*)slots;
+    Block* out = s + p.atoms.size();
+    for(const Program::Instruction& instruction : p.code) {
+        Block l = s[instruction.left], r = s[instruction.right];
+        uint64_t m0 = -(uint64_t)(instruction.op & 1), m1 = -(uint64_t)(instruction.op >> 1 & 1);
+        uint64_t m2 = -(uint64_t)(instruction.op >> 2 & 1), m3 = -(uint64_t)(instruction.op >> 3 & 1);
+        *out++ = (l & ((r & m3) | (~r & m2))) | (~l & ((r & m1) | (~r & m0)));
+    }
+    std::copy(slots + p.result * words, slots + (p.result + 1) * words, result);
+}
+
+// Jezgro racuna 64 * words vrsta od vrste first; slots ima mesta za
+// (atoms.size() + code.size()) * words reci i poravnat je na 64 bajta.
+struct RowEngine {
+    void (*evaluate)(const Program& p, uint64_t first, uint64_t* result, uint64_t* slots);
+    int words;
+};
+
+void evaluateRowsScalar(const Program& p, uint64_t first, uint64_t* result, uint64_t* slots) {
+    evaluateRows<Block64>(p, first, result, slots);
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+__attribute__((target("avx2")))
+void evaluateRowsAvx2(const Program& p, uint64_t first, uint64_t* result, uint64_t* slots) {
+    evaluateRows<Block256>(p, first, result, slots);
+}
+
+__attribute__((target("avx512f")))
+void evaluateRowsAvx512(const Program& p, uint64_t first, uint64_t* result, uint64_t* slots) {
+    evaluateRows<Block512>(p, first, result, slots);
+}
+#endif
+
+// Najsire jezgro koje procesor podrzava, izabrano jednom pri prvom pozivu.
+const RowEngine& rowEngine() {
+    static const RowEngine engine = [] {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f"))
+            return RowEngine{evaluateRowsAvx512, 8};
+        if(__builtin_cpu_supports("avx2"))
+            return RowEngine{evaluateRowsAvx2, 4};
+#endif
+        return RowEngine{evaluateRowsScalar, 1};
+    }();
+    return engine;
+}
 
-    Valuation v;
-    for(const auto& atom : atoms)
-        v[atom] = false;
+// Za svaki blok vrsta od vrste begin (deljive sa 512) do vrste end poziva
+// visit(first, bits, count): bits su vrednosti formule za vrste
+// first..first+count-1 (count <= 64), a visit vraca false kada treba stati.
+template<typename Visit>
+void forEachRow(const Program& p, uint64_t begin, uint64_t end, Visit visit) {
+    const RowEngine& engine = rowEngine();
+    std::vector<uint64_t> buffer((p.atoms.size() + p.code.size()) * engine.words + 8);
+    uint64_t* slots = (uint64_t*)(((uintptr_t)buffer.data() + 63) & ~(uintptr_t)63);
+    std::vector<uint64_t> result(engine.words);
+    for(uint64_t first = begin; first < end; first += 64 * engine.words) {
+        engine.evaluate(p, first, result.data(), slots);
+        for(int w = 0; w < engine.words && first + 64 * w < end; w++) {
+            uint64_t start = first + 64 * w;
+            int count = std::min<uint64_t>(64, end - start);
+            uint64_t bits = count == 64 ? result[w] : result[w] & ((uint64_t(1) << count) - 1);
+            if(!visit(start, bits, count))
+                return;
+        }
+    }
+}
 
-    do {
-        if(evaluate(f, v))
-            return v;
-    } while(next(v));
-    return {};
+template<typename Visit>
+void forEachRow(const Program& p, Visit visit) {
+    forEachRow(p, 0, uint64_t(1) << p.atoms.size(), visit);
+}
+
+// Sta table ispisuje: sve vrste, samo vrste u kojima je formula tacna, samo
+// broj takvih vrsta, ili kolonu vrednosti formule kao bitmapu. U bitmapi je
+// svaki red jedna 64-bitna rec heksadekadno (bit k reda i je vrsta 64i + k),
+// a niz jednakih reci se pise kao "rec*ponavljanja".
+struct TableOptions {
+    enum Output { Rows, Satisfying, Count, Bitmap } output = Rows;
+    // Broj niti; 0 znaci koliko procesor ima jezgara.
+    unsigned threads = 0;
+};
+
+// Tekst tablice za vrste first..last-1 se dodaje na text; vraca broj vrsta
+// u kojima je formula tacna.
+uint64_t tableChunk(const Program& p, uint64_t first, uint64_t last, TableOptions::Output output, std::string& text) {
+    size_t n = p.atoms.size();
+    std::string row(2 * n + 4, ' ');
+    row[2 * n] = '|';
+    row[2 * n + 3] = '\n';
+    uint64_t count = 0, run = 0, runLength = 0;
+    auto writeRun = [&] {
+        const char* digits = "0123456789abcdef";
+        for(int shift = 60; shift >= 0; shift -= 4)
+            text += digits[run >> shift & 15];
+        if(runLength > 1)
+            text += '*' + std::to_string(runLength);
+        text += '\n';
+    };
+    forEachRow(p, first, last, [&](uint64_t start, uint64_t bits, int rows) {
+        count += __builtin_popcountll(bits);
+        if(output == TableOptions::Bitmap) {
+            if(runLength > 0 && bits == run)
+                runLength++;
+            else {
+                if(runLength > 0)
+                    writeRun();
+                run = bits;
+                runLength = 1;
+            }
+        }
+        else if(output != TableOptions::Count) {
+            for(int k = 0; k < rows; k++) {
+                bool value = bits >> k & 1;
+                if(output == TableOptions::Satisfying && !value)
+                    continue;
+                for(size_t i = 0; i < n; i++)
+                    row[2 * i] = '0' + ((start + k) >> i & 1);
+                row[2 * n + 2] = '0' + value;
+                text += row;
+            }
+        }
+        return true;
+    });
+    if(runLength > 0)
+        writeRun();
+    return count;
+}
+
+// Istinitosna tablica formule. Vrste se dele na delove sa fiksiranim
+// vrednostima poslednjih atoma, koje niti racunaju u svoje bafere, a
+// pozivalac ih ispisuje redom, pa je izlaz isti kao kod jedne niti. Najvise
+// 2 * threads delova ceka na ispis, pa memorija ne raste sa velicinom
+// tablice. Vraca broj vrsta u kojima je formula tacna.
+uint64_t table(const FormulaPtr& f, const TableOptions& options = {}) {
+    Program program = compile(f);
+    if(options.output != TableOptions::Count) {
+        for(AtomId atom : program.atoms)
+            std::cout << atomName(atom) << ' ';
+        std::cout << '\n';
+    }
+
+    bool rows = options.output == TableOptions::Rows || options.output == TableOptions::Satisfying;
+    uint64_t size = uint64_t(1) << program.atoms.size();
+    uint64_t chunkSize = std::min<uint64_t>(size, rows ? 1 << 16 : 1 << 22);
+    uint64_t chunks = size / chunkSize;
+    unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<uint64_t>(threads, chunks);
+    size_t window = 2 * threads;
+
+    std::vector<std::string> done(window);
+    std::vector<char> ready(window, false);
+    uint64_t claimed = 0, written = 0;
+    std::atomic<uint64_t> count{0};
+    std::mutex mutex;
+    std::condition_variable changed;
+    auto worker = [&] {
+        std::string text;
+        while(true) {
+            uint64_t chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return claimed == chunks || claimed < written + window; });
+                if(claimed == chunks)
+                    return;
+                chunk = claimed++;
+            }
+            text.clear();
+            count += tableChunk(program, chunk * chunkSize, (chunk + 1) * chunkSize, options.output, text);
+            std::lock_guard<std::mutex> lock(mutex);
+            done[chunk % window].swap(text);
+            ready[chunk % window] = true;
+            changed.notify_all();
+        }
+    };
+    std::vector<std::thread> pool;
+    for(unsigned i = 0; i < threads; i++)
+        pool.emplace_back(worker);
+    for(uint64_t chunk = 0; chunk < chunks; chunk++) {
+        std::string text;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return ready[chunk % window]; });
+            text.swap(done[chunk % window]);
+            ready[chunk % window] = false;
+            written++;
+        }
+        changed.notify_all();
+        std::cout.write(text.data(), text.size());
+    }
+    for(std::thread& thread : pool)
+        thread.join();
+
+    if(options.output == TableOptions::Count)
+        std::cout << count << '\n';
+    std::cout.flush();
+    return count;
+}
+
+std::optional<Valuation> isSatisfiable(const FormulaPtr& f) {
+    Program program = compile(f);
+    std::optional<Valuation> model;
+    forEachRow(program, [&](uint64_t first, uint64_t bits, int) {
+        if(!bits)
+            return true;
+        uint64_t row = first + __builtin_ctzll(bits);
+        model = Valuation{};
+        for(size_t i = 0; i < program.atoms.size(); i++)
+            (*model)[program.atoms[i]] = row >> i & 1;
+        return false;
+    });
+    return model;
 }
 
 FormulaPtr simplify(const FormulaPtr& f) {
@@ -278,6 +664,7 @@ FormulaPtr nnfNot(const FormulaPtr& f) {
             ptr(Binary{Binary::And, nnf(b.left), nnfNot(b.right)}),
             ptr(Binary{Binary::And, nnfNot(b.left), nnf(b.right)})
         });
+    return FormulaPtr{};
 }
 
 FormulaPtr nnf(const FormulaPtr& f) {
@@ -322,9 +709,9 @@ NormalForm cnf(const FormulaPtr& f) {
     if(is<False>(f))
         return {{}};
     if(is<Atom>(f))
-        return {{Literal{true, as<Atom>(f).name}}};
+        return {{Literal{true, as<Atom>(f).id}}};
     if(is<Not>(f))
-        return {{Literal{false, as<Atom>(as<Not>(f).subformula).name}}};
+        return {{Literal{false, as<Atom>(as<Not>(f).subformula).id}}};
     auto b = as<Binary>(f);
     if(b.type == Binary::And)
         return concat(cnf(b.left), cnf(b.right));
@@ -337,23 +724,24 @@ void print(const NormalForm& f) {
     for(const auto& clause : f) {
         std::cout << "[ ";
         for (const auto &literal: clause)
-            std::cout << (literal.pos ? "" : "~") << literal.name << " ";
+            std::cout << (literal.pos ? "" : "~") << atomName(literal.atom) << " ";
         std::cout << "]";
     }
     std::cout << std::endl;
 }
 
 int main() {
-   FormulaPtr p = ptr(Atom{"p"});
-   FormulaPtr q = ptr(Atom{"q"});
-   FormulaPtr r = ptr(Atom{"r"});
+   FormulaPtr p = ptr(Atom{intern("p")});
+   FormulaPtr q = ptr(Atom{intern("q")});
+   FormulaPtr r = ptr(Atom{intern("r")});
    FormulaPtr p_and_q = ptr(Binary{Binary::And, p, q});
    FormulaPtr not_r = ptr(Not{r});
    FormulaPtr p_and_q_implies_not_r = ptr(Binary{Binary::Impl, p_and_q, not_r});
    std::cout << complexity(p_and_q) << std::endl;
    std::cout << print(p_and_q) << std::endl;
-   Valuation v = {{"p", true}, {"q", false}};
-   std::cout << (evaluate(p_and_q, v) ? "True" : "False") << std::endl;
+   Valuation v = {{intern("p"), true}, {intern("q"), false}};
+   Program program = compile(p_and_q);
+   std::cout << (evaluate(program, valuation(program, v)) ? "True" : "False") << std::endl;
 
    table(p_and_q_implies_not_r);
    return 0;
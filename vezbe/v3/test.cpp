@@ -0,0 +1,130 @@
+// Testovi: main.cpp se ukljucuje sa preimenovanom funkcijom main.
+// Prevodjenje: g++ -std=c++17 -O2 -pthread test.cpp -o test
+#define main formulaMain
+#include "main.cpp"
+#undef main
+#include <sstream>
+
+int failures = 0;
+
+void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "OK    " : "GRESKA") << " " << name << std::endl;
+    if(!condition)
+        failures++;
+}
+
+template<typename F>
+std::string captured(F f) {
+    std::ostringstream out;
+    std::streambuf* old = std::cout.rdbuf(out.rdbuf());
+    f();
+    std::cout.rdbuf(old);
+    return out.str();
+}
+
+// Kolone i vrste tablice su po imenu atoma, kao pre uvodjenja
+// identifikatora, iako su atomi ucitani obrnutim redom; izlaz ne zavisi
+// od broja niti.
+void tableOrder() {
+    FormulaPtr z = ptr(Atom{intern("z")});
+    FormulaPtr y = ptr(Atom{intern("y")});
+    FormulaPtr x = ptr(Atom{intern("x")});
+    FormulaPtr f = ptr(Binary{Binary::Impl, ptr(Binary{Binary::And, z, y}), ptr(Not{x})});
+    std::string expected =
+        "x y z \n"
+        "0 0 0 | 1\n"
+        "1 0 0 | 1\n"
+        "0 1 0 | 1\n"
+        "1 1 0 | 1\n"
+        "0 0 1 | 1\n"
+        "1 0 1 | 1\n"
+        "0 1 1 | 1\n"
+        "1 1 1 | 0\n";
+    for(unsigned threads : {1u, 3u})
+        check(captured([&] { table(f, {TableOptions::Rows, threads}); }) == expected,
+              "table: kolone i vrste po imenu, niti: " + std::to_string(threads));
+}
+
+// Prevedeni program mora da se slaze sa rekurzivnim evaluate u svakoj
+// valuaciji, ukljucujuci konstante i zajednicke podformule.
+void compiledEvaluate() {
+    FormulaPtr p = ptr(Atom{intern("p")});
+    FormulaPtr q = ptr(Atom{intern("q")});
+    FormulaPtr r = ptr(Atom{intern("r")});
+    FormulaPtr s = ptr(Atom{intern("s")});
+    FormulaPtr pq = ptr(Binary{Binary::And, p, q});
+    FormulaPtr formulas[] = {
+        p,
+        ptr(True{}),
+        ptr(Not{ptr(False{})}),
+        ptr(Binary{Binary::Impl, pq, ptr(Not{r})}),
+        ptr(Binary{Binary::Eq, ptr(Binary{Binary::Or, pq, s}), ptr(Not{pq})}),
+        ptr(Binary{Binary::Or, ptr(Binary{Binary::Impl, s, ptr(Binary{Binary::Eq, q, p})}), ptr(Binary{Binary::And, r, ptr(False{})})}),
+    };
+    for(const FormulaPtr& f : formulas) {
+        Program program = compile(f);
+        std::vector<uint8_t> values(program.atoms.size(), 0);
+        bool agree = true;
+        int rows = 0;
+        do {
+            Valuation v;
+            for(size_t i = 0; i < values.size(); i++)
+                v[program.atoms[i]] = values[i];
+            agree = agree && evaluate(program, values) == evaluate(f, v);
+            rows++;
+        } while(next(values));
+        check(agree && rows == 1 << program.atoms.size(), "compile: " + print(f));
+    }
+}
+
+// (p /\ q) => ~r, svaki put iz novih cvorova.
+FormulaPtr example() {
+    FormulaPtr p = ptr(Atom{intern("p")});
+    FormulaPtr q = ptr(Atom{intern("q")});
+    FormulaPtr r = ptr(Atom{intern("r")});
+    return ptr(Binary{Binary::Impl, ptr(Binary{Binary::And, p, q}), ptr(Not{r})});
+}
+
+// Strukturno jednake formule su isti cvor, a razlicite nisu; to vazi i
+// kada cvorove istovremeno prave vise niti.
+void sharedNodes() {
+    FormulaPtr f = example();
+    FormulaPtr p = ptr(Atom{intern("p")});
+    FormulaPtr q = ptr(Atom{intern("q")});
+    check(example() == f && equal(example(), f), "ptr: strukturno jednake formule su isti cvor");
+    check(ptr(Binary{Binary::And, p, q}) != ptr(Binary{Binary::And, q, p})
+          && ptr(Binary{Binary::And, p, q}) != ptr(Binary{Binary::Or, p, q})
+          && ptr(Not{p}) != ptr(Not{q}) && ptr(True{}) == ptr(True{}),
+          "ptr: razlicite formule su razliciti cvorovi");
+    std::vector<FormulaPtr> built(4);
+    std::vector<std::thread> threads;
+    for(size_t i = 0; i < built.size(); i++)
+        threads.emplace_back([&built, i] {
+            for(int j = 0; j < 2000; j++)
+                built[i] = ptr(Not{ptr(Not{ptr(Atom{AtomId(1000 + j % 50)})})});
+        });
+    for(std::thread& thread : threads)
+        thread.join();
+    bool same = true;
+    for(const FormulaPtr& g : built)
+        same = same && g == built[0];
+    check(same, "ptr: niti dobijaju isti cvor");
+}
+
+// Istekli ulazi se izbacuju, pa tabela ne raste sa brojem formula koje su
+// napravljene i odbacene, a zive formule ostaju u njoj.
+void purgeExpired() {
+    FormulaPtr f = example();
+    for(AtomId atom = 0; atom < 100000; atom++)
+        ptr(Not{ptr(Atom{atom + 2000})});
+    check(uniqueTable().nodes.size() < 4096, "ptr: istekli ulazi su izbaceni");
+    check(example() == f, "ptr: zive formule ostaju u tabeli");
+}
+
+int main() {
+    sharedNodes();
+    purgeExpired();
+    compiledEvaluate();
+    tableOrder();
+    return failures > 0;
+}
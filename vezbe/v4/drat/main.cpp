@@ -0,0 +1,666 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using Atom = int;
+using Literal = int;
+
+// Kao u resavacu: literal je 2 * atom za pozitivan, odnosno 2 * atom + 1
+// za negiran literal. To je ujedno i kodiranje literala u binarnom DRAT-u.
+using Lit = uint32_t;
+
+Lit toLit(Literal l) { return l > 0 ? 2u * l : 2u * -l + 1; }
+Literal toLiteral(Lit l) { return l & 1 ? -(Literal)(l >> 1) : (Literal)(l >> 1); }
+Atom atomOf(Lit l) { return l >> 1; }
+
+const int NoReason = -1;
+const signed char Removed = -1;
+
+// Klauza na listi pracenja literala, uz neki njen literal: ako je on
+// tacan, klauza se ne mora citati.
+struct Watch {
+    int id;
+    Lit blocker;
+};
+
+// Provera DRAT dokaza unazad. Unapred se dodaju originalne klauze i leme
+// dok propagacija na nivou 0 ne dovede do konflikta. Zatim se od
+// konflikta ide unazad: oznacavaju se klauze koje ucestvuju u konfliktu,
+// a proverava se samo lema koja je oznacena, i to propagacijom iz negacije
+// leme (RUP), odnosno proverom RAT svojstva po prvom literalu. Pri
+// propagaciji se prvo koriste vec oznacene klauze, pa je jezgro manje.
+struct Checker {
+    int atomCount = 0;
+    // Klauze su jedna za drugom u literals; id klauze indeksira ostale nizove.
+    std::vector<Lit> literals;
+    std::vector<size_t> start;
+    std::vector<uint32_t> length;
+    std::vector<Lit> pivot;
+    // 1 za aktivnu klauzu, 0 za obrisanu koja se pri prolasku unazad vraca
+    // i Removed za lemu koja je unazad uklonjena i vise se ne koristi; ona
+    // se sa lista pracenja skida tek kada je propagacija naidje.
+    std::vector<signed char> active;
+    std::vector<char> marked;
+    size_t originalCount = 0;
+    // Korak dokaza je 2 * id za dodavanje i 2 * id + 1 za brisanje klauze.
+    std::vector<int> steps;
+    std::unordered_map<uint64_t, std::vector<int>> byHash;
+
+    std::vector<signed char> value;
+    std::vector<int> reason;
+    std::vector<size_t> position;
+    std::vector<Lit> trail;
+    std::vector<size_t> trailBefore;
+    std::vector<std::vector<Watch>> watches;
+    size_t processedCore = 0;
+    size_t processedAll = 0;
+    // Atom cija je dodela vec opravdana oznacenim klauzama. Oznake se ne
+    // skidaju, pa je to tacno dok se atom ne povuce bektrekingom.
+    std::vector<char> justified;
+    std::vector<Atom> stack;
+
+    long long ignoredDeletions = 0;
+    long long checkedLemmas = 0;
+    long long ratLemmas = 0;
+
+    Lit* begin(int id) { return literals.data() + start[id]; }
+    Lit* end(int id) { return begin(id) + length[id]; }
+
+    bool isTrue(Lit l) const { return value[atomOf(l)] == (l & 1 ? -1 : 1); }
+    bool isFalse(Lit l) const { return value[atomOf(l)] == (l & 1 ? 1 : -1); }
+
+    void grow(int atoms) {
+        if(atoms <= atomCount)
+            return;
+        atomCount = atoms;
+        value.resize(atomCount + 1, 0);
+        reason.resize(atomCount + 1, NoReason);
+        position.resize(atomCount + 1, 0);
+        justified.resize(atomCount + 1, 0);
+        watches.resize(2 * atomCount + 2);
+    }
+
+    // Hes ne zavisi od redosleda literala, pa brisanje nalazi klauzu cak i
+    // ako su literali u dokazu drugacije poredjani.
+    uint64_t hash(const Lit* first, const Lit* last) const {
+        uint64_t sum = 0, product = 1, x = 0;
+        for(const Lit* l = first; l != last; l++) {
+            sum += *l;
+            product *= 2 * (uint64_t)*l + 1;
+            x ^= (uint64_t)*l * 0x9e3779b97f4a7c15ull;
+        }
+        return sum * 1000003 ^ product ^ x;
+    }
+
+    int store(const std::vector<Lit>& clause) {
+        int id = start.size();
+        start.push_back(literals.size());
+        length.push_back(clause.size());
+        pivot.push_back(clause.empty() ? 0 : clause[0]);
+        // Ponovljeni literal se izostavlja, da klauza ne bi dva puta pratila
+        // isti literal; redosled se cuva zbog pivota.
+        for(Lit l : clause)
+            if(std::find(literals.begin() + start.back(), literals.end(), l) == literals.end())
+                literals.push_back(l);
+        length.back() = literals.size() - start.back();
+        active.push_back(0);
+        marked.push_back(0);
+        for(Lit l : clause)
+            grow(atomOf(l));
+        return id;
+    }
+
+    void addOriginal(const std::vector<Lit>& clause) {
+        store(clause);
+        originalCount++;
+    }
+
+    void addStep(const std::vector<Lit>& clause, bool deletion) {
+        if(!deletion) {
+            steps.push_back(2 * store(clause));
+            return;
+        }
+        // Brisanje se razresava tek pri prolasku unapred, kada je poznato
+        // koje su klauze aktivne; do tada se cuva kao privremena klauza.
+        steps.push_back(2 * store(clause) + 1);
+    }
+
+    void assign(Lit l, int from) {
+        value[atomOf(l)] = l & 1 ? -1 : 1;
+        reason[atomOf(l)] = from;
+        position[atomOf(l)] = trail.size();
+        trail.push_back(l);
+    }
+
+    void backtrack(size_t size) {
+        while(trail.size() > size) {
+            value[atomOf(trail.back())] = 0;
+            justified[atomOf(trail.back())] = 0;
+            trail.pop_back();
+        }
+        processedCore = processedAll = trail.size();
+    }
+
+    void watch(int id) {
+        Lit* lits = begin(id);
+        watches[lits[0]].push_back({id, lits[1]});
+        watches[lits[1]].push_back({id, lits[0]});
+    }
+
+    void unwatch(int id) {
+        for(int k = 0; k < 2; k++) {
+            std::vector<Watch>& ws = watches[begin(id)[k]];
+            ws.erase(std::find_if(ws.begin(), ws.end(), [&](const Watch& w) { return w.id == id; }));
+        }
+    }
+
+    // Dodaje klauzu u aktivne. Prati dva literala koji nisu netacni; ako
+    // takav postoji samo jedan, klauza je jedinicna i taj literal se
+    // dodeljuje. Vraca false ako je klauza netacna.
+    bool attach(int id) {
+        active[id] = 1;
+        Lit* lits = begin(id);
+        uint32_t size = length[id];
+        if(size == 0)
+            return false;
+        std::stable_partition(lits, lits + size, [&](Lit l) { return !isFalse(l); });
+        if(size >= 2) {
+            if(isFalse(lits[1])) {
+                // Drugi prati netacan literal koji je poslednji dodeljen, pa
+                // posle bektrekinga postaje prvi nedodeljen.
+                uint32_t last = 1;
+                for(uint32_t k = 2; k < size; k++)
+                    if(position[atomOf(lits[k])] > position[atomOf(lits[last])])
+                        last = k;
+                std::swap(lits[1], lits[last]);
+            }
+            watch(id);
+        }
+        if(isFalse(lits[0]))
+            return false;
+        if(!isTrue(lits[0]) && (size == 1 || isFalse(lits[1])))
+            assign(lits[0], id);
+        return true;
+    }
+
+    // Propagacija dvostrukim pracenjem. Svaki literal sa steka se prvo
+    // obradi samo sa oznacenim klauzama, pa tek kada tu nema novih
+    // dodela, sa neoznacenim. Vraca klauzu u konfliktu ili -1.
+    int propagate() {
+        while(true) {
+            bool core = processedCore < trail.size();
+            if(!core && processedAll == trail.size())
+                return -1;
+            Lit falseLit = trail[core ? processedCore++ : processedAll++] ^ 1;
+            std::vector<Watch>& ws = watches[falseLit];
+            size_t i = 0, j = 0;
+            while(i < ws.size()) {
+                Watch w = ws[i++];
+                int id = w.id;
+                if(active[id] == Removed)
+                    continue;
+                if((bool)marked[id] != core || isTrue(w.blocker)) {
+                    ws[j++] = w;
+                    continue;
+                }
+                Lit* lits = begin(id);
+                if(lits[0] == falseLit)
+                    std::swap(lits[0], lits[1]);
+                if(isTrue(lits[0])) {
+                    ws[j++] = {id, lits[0]};
+                    continue;
+                }
+                bool moved = false;
+                for(uint32_t k = 2; k < length[id]; k++) {
+                    if(!isFalse(lits[k])) {
+                        std::swap(lits[1], lits[k]);
+                        watches[lits[1]].push_back({id, lits[0]});
+                        moved = true;
+                        break;
+                    }
+                }
+                if(moved)
+                    continue;
+                ws[j++] = {id, lits[0]};
+                if(isFalse(lits[0])) {
+                    while(i < ws.size())
+                        ws[j++] = ws[i++];
+                    ws.resize(j);
+                    return id;
+                }
+                assign(lits[0], id);
+            }
+            ws.resize(j);
+        }
+    }
+
+    // Oznacava razloge dodele atoma i, pretragom u dubinu, sve razloge od
+    // kojih oni zavise.
+    void justify(Atom atom) {
+        if(justified[atom])
+            return;
+        justified[atom] = 1;
+        stack.push_back(atom);
+        while(!stack.empty()) {
+            Atom a = stack.back();
+            stack.pop_back();
+            int r = reason[a];
+            if(r == NoReason)
+                continue;
+            marked[r] = 1;
+            for(const Lit* l = begin(r); l != end(r); l++) {
+                if(!justified[atomOf(*l)]) {
+                    justified[atomOf(*l)] = 1;
+                    stack.push_back(atomOf(*l));
+                }
+            }
+        }
+    }
+
+    // Oznacava klauzu u konfliktu i sve razloge od kojih ona zavisi.
+    void analyze(int conflict) {
+        marked[conflict] = 1;
+        for(const Lit* l = begin(conflict); l != end(conflict); l++)
+            justify(atomOf(*l));
+    }
+
+    // Da li iz negacije klauze propagacijom sledi konflikt. Ako sledi,
+    // oznacavaju se klauze koje su za to potrebne.
+    bool rup(const std::vector<Lit>& clause) {
+        size_t before = trail.size();
+        bool conflict = false;
+        for(Lit l : clause) {
+            if(isTrue(l)) {
+                justify(atomOf(l));
+                conflict = true;
+                break;
+            }
+            if(!isFalse(l))
+                assign(l ^ 1, NoReason);
+        }
+        if(!conflict) {
+            int c = propagate();
+            if(c != -1) {
+                analyze(c);
+                conflict = true;
+            }
+        }
+        backtrack(before);
+        return conflict;
+    }
+
+    // RUP, a ako to ne uspe, RAT po prvom literalu leme: svaka rezolventa
+    // sa aktivnom klauzom koja sadrzi negaciju pivota mora biti RUP.
+    bool verify(int id) {
+        std::vector<Lit> lemma(begin(id), end(id));
+        checkedLemmas++;
+        if(rup(lemma))
+            return true;
+        if(lemma.empty())
+            return false;
+        ratLemmas++;
+        Lit p = pivot[id];
+        std::vector<Lit> resolvent;
+        for(int other = 0; other < (int)start.size(); other++) {
+            if(active[other] != 1 || std::find(begin(other), end(other), p ^ 1) == end(other))
+                continue;
+            resolvent = lemma;
+            for(const Lit* l = begin(other); l != end(other); l++)
+                if(*l != (p ^ 1))
+                    resolvent.push_back(*l);
+            if(!rup(resolvent))
+                return false;
+            marked[other] = 1;
+        }
+        return true;
+    }
+
+    void index(int id) {
+        std::vector<Lit> sorted(begin(id), end(id));
+        std::sort(sorted.begin(), sorted.end());
+        byHash[hash(sorted.data(), sorted.data() + sorted.size())].push_back(id);
+    }
+
+    // Trazi aktivnu klauzu sa istim literalima kao privremena klauza
+    // deletion i uklanja je iz indeksa. Vraca -1 ako takve nema.
+    int find(int deletion) {
+        std::vector<Lit> sorted(begin(deletion), end(deletion));
+        std::sort(sorted.begin(), sorted.end());
+        auto it = byHash.find(hash(sorted.data(), sorted.data() + sorted.size()));
+        if(it == byHash.end())
+            return -1;
+        std::vector<int>& ids = it->second;
+        std::vector<Lit> other;
+        for(size_t k = ids.size(); k-- > 0;) {
+            other.assign(begin(ids[k]), end(ids[k]));
+            std::sort(other.begin(), other.end());
+            if(other == sorted && active[ids[k]] == 1) {
+                int id = ids[k];
+                ids.erase(ids.begin() + k);
+                return id;
+            }
+        }
+        return -1;
+    }
+
+    bool isReason(int id) {
+        for(const Lit* l = begin(id); l != end(id); l++)
+            if(isTrue(*l) && reason[atomOf(*l)] == id)
+                return true;
+        return false;
+    }
+
+    // Vraca false ako dokaz nije ispravan.
+    bool check() {
+        int conflict = -1;
+        for(size_t id = 0; id < originalCount && conflict == -1; id++) {
+            index(id);
+            if(!attach(id))
+                conflict = id;
+        }
+        if(conflict == -1)
+            conflict = propagate();
+
+        // Prolaz unapred do prvog konflikta.
+        size_t last = 0;
+        trailBefore.assign(steps.size(), 0);
+        for(; last < steps.size() && conflict == -1; last++) {
+            int id = steps[last] >> 1;
+            trailBefore[last] = trail.size();
+            if(steps[last] & 1) {
+                int target = find(id);
+                // Brisanje jedinicnih klauza i razloga se ignorise, kao u
+                // drat-trim-u, jer bi promenilo dodele na nivou 0.
+                if(target == -1 || length[target] <= 1 || isReason(target)) {
+                    ignoredDeletions++;
+                    steps[last] = -1;
+                    if(target != -1)
+                        index(target);
+                    continue;
+                }
+                // Obrisana klauza se skida sa lista pracenja. Pri prolasku
+                // unazad se vraca kada je trag isti kao sada, pa su njeni
+                // praceni literali i tada ispravni.
+                active[target] = 0;
+                unwatch(target);
+                steps[last] = 2 * target + 1;
+                continue;
+            }
+            index(id);
+            if(!attach(id))
+                conflict = id;
+            else
+                conflict = propagate();
+        }
+        if(conflict == -1)
+            return false;
+
+        // Prolaz unazad od konflikta.
+        analyze(conflict);
+        for(size_t s = last; s-- > 0;) {
+            if(steps[s] == -1)
+                continue;
+            int id = steps[s] >> 1;
+            if(steps[s] & 1) {
+                active[id] = 1;
+                watch(id);
+                continue;
+            }
+            active[id] = Removed;
+            backtrack(trailBefore[s]);
+            if(marked[id] && !verify(id))
+                return false;
+        }
+        return true;
+    }
+
+    // Oznacene leme redom kojim su dodate, kao tekstualni DRAT. Zadrzavaju
+    // se i brisanja oznacenih klauza, jer od skupa aktivnih klauza zavisi
+    // provera RAT svojstva.
+    void writeTrimmed(std::ostream& out) {
+        for(int step : steps) {
+            if(step == -1 || !marked[step >> 1])
+                continue;
+            int id = step >> 1;
+            Lit p = pivot[id];
+            if(step & 1)
+                out << "d ";
+            else if(length[id] > 0)
+                out << toLiteral(p) << ' ';
+            for(const Lit* l = begin(id); l != end(id); l++)
+                if((step & 1) || *l != p)
+                    out << toLiteral(*l) << ' ';
+            out << "0\n";
+        }
+    }
+
+    // Nezadovoljivo jezgro: oznacene originalne klauze u DIMACS-u.
+    void writeCore(std::ostream& out) {
+        size_t count = 0;
+        for(size_t id = 0; id < originalCount; id++)
+            count += marked[id];
+        out << "p cnf " << atomCount << ' ' << count << '\n';
+        for(size_t id = 0; id < originalCount; id++) {
+            if(!marked[id])
+                continue;
+            for(const Lit* l = begin(id); l != end(id); l++)
+                out << toLiteral(*l) << ' ';
+            out << "0\n";
+        }
+    }
+};
+
+// Ceo fajl u memoriji: mapiran ako je moguce, inace procitan.
+struct Input {
+    const char* data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    std::string buffer;
+
+    bool open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0)
+            return false;
+        struct stat st;
+        if(fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size = st.st_size;
+        if(S_ISREG(st.st_mode) && size > 0) {
+            void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(p != MAP_FAILED) {
+                madvise(p, size, MADV_SEQUENTIAL);
+                data = static_cast<const char*>(p);
+                mapped = true;
+                ::close(fd);
+                return true;
+            }
+        }
+        char chunk[1 << 16];
+        ssize_t n;
+        while((n = ::read(fd, chunk, sizeof chunk)) > 0)
+            buffer.append(chunk, n);
+        ::close(fd);
+        data = buffer.data();
+        size = buffer.size();
+        return true;
+    }
+
+    ~Input() {
+        if(mapped)
+            munmap(const_cast<char*>(data), size);
+    }
+};
+
+// Tekstualni DIMACS ili DRAT: klauze su nizovi brojeva zavrseni nulom,
+// komentari pocinju sa 'c', zaglavlje sa 'p', a u DRAT-u 'd' oznacava
+// brisanje. Za svaku klauzu poziva se f(klauza, brisanje).
+template<typename F>
+bool parseText(const char* p, const char* end, F f) {
+    std::vector<Lit> clause;
+    bool deletion = false;
+    while(p < end) {
+        char ch = *p;
+        if(ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r') {
+            p++;
+            continue;
+        }
+        if(ch == 'c' || ch == 'p' || ch == '%') {
+            if(ch == '%')
+                break;
+            p = (const char*)std::memchr(p, '\n', end - p);
+            if(p == nullptr)
+                p = end;
+            continue;
+        }
+        if(ch == 'd') {
+            deletion = true;
+            p++;
+            continue;
+        }
+        bool negative = ch == '-';
+        if(negative)
+            p++;
+        if(p == end || *p < '0' || *p > '9')
+            return false;
+        Literal x = 0;
+        while(p < end && *p >= '0' && *p <= '9')
+            x = 10 * x + (*p++ - '0');
+        if(x == 0) {
+            f(clause, deletion);
+            clause.clear();
+            deletion = false;
+        }
+        else
+            clause.push_back(toLit(negative ? -x : x));
+    }
+    return clause.empty();
+}
+
+template<typename F>
+bool parseBinary(const unsigned char* p, const unsigned char* end, F f) {
+    std::vector<Lit> clause;
+    while(p < end) {
+        unsigned char kind = *p++;
+        if(kind != 'a' && kind != 'd')
+            return false;
+        clause.clear();
+        while(true) {
+            uint32_t x = 0;
+            int shift = 0;
+            do {
+                if(p == end)
+                    return false;
+                x |= (uint32_t)(*p & 127) << shift;
+                shift += 7;
+            } while(*p++ & 128);
+            if(x == 0)
+                break;
+            clause.push_back(x);
+        }
+        f(clause, kind == 'd');
+    }
+    return true;
+}
+
+// Binarni dokaz pocinje bajtom 'a' ili 'd' bez razmaka iza, ili u
+// pocetku ima bajtove koji se ne javljaju u tekstualnom DRAT-u.
+bool isBinary(const char* p, size_t size) {
+    if(size == 0)
+        return false;
+    if(p[0] == 'a' || (p[0] == 'd' && size > 1 && p[1] != ' '))
+        return true;
+    for(size_t i = 0; i < std::min<size_t>(size, 256); i++)
+        if(!std::strchr("0123456789- \t\r\ndc", p[i]))
+            return true;
+    return false;
+}
+
+// Za argument oblika --name=value upisuje value i vraca true.
+bool option(const std::string& arg, const std::string& name, std::string& value) {
+    if(arg.compare(0, name.size() + 1, name + "=") != 0)
+        return false;
+    value = arg.substr(name.size() + 1);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths;
+    std::string corePath, trimmedPath;
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i], value;
+        if(arg.empty() || arg[0] != '-')
+            paths.push_back(arg);
+        else if(option(arg, "--core", value))
+            corePath = value;
+        else if(option(arg, "--trimmed", value))
+            trimmedPath = value;
+        else {
+            std::cerr << "Nepoznata opcija: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if(paths.size() != 2) {
+        std::cerr << "Upotreba: drat formula.cnf dokaz.drat [--core=fajl] [--trimmed=fajl]" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Checker checker;
+    Input cnf, proof;
+    if(!cnf.open(paths[0]) || !proof.open(paths[1])) {
+        std::cerr << "Neuspesno otvaranje ulaza" << std::endl;
+        return 1;
+    }
+    bool parsed = parseText(cnf.data, cnf.data + cnf.size, [&](const std::vector<Lit>& clause, bool) {
+        checker.addOriginal(clause);
+    });
+    auto step = [&](const std::vector<Lit>& clause, bool deletion) {
+        checker.addStep(clause, deletion);
+    };
+    bool binary = isBinary(proof.data, proof.size);
+    parsed = parsed && (binary
+        ? parseBinary((const unsigned char*)proof.data, (const unsigned char*)proof.data + proof.size, step)
+        : parseText(proof.data, proof.data + proof.size, step));
+    if(!parsed) {
+        std::cerr << "Neispravan ulaz" << std::endl;
+        return 1;
+    }
+    std::chrono::duration<double> parseTime = std::chrono::steady_clock::now() - start;
+
+    bool verified = checker.check();
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    long long coreClauses = 0, coreLemmas = 0;
+    for(size_t id = 0; id < checker.start.size(); id++)
+        (id < checker.originalCount ? coreClauses : coreLemmas) += checker.marked[id];
+    std::cout << "c format: " << (binary ? "binary" : "text") << std::endl;
+    std::cout << "c parse: " << parseTime.count() << " s" << std::endl;
+    std::cout << "c check: " << time.count() - parseTime.count() << " s" << std::endl;
+    std::cout << "c core: " << coreClauses << " of " << checker.originalCount << " clauses" << std::endl;
+    std::cout << "c lemmas: " << coreLemmas << " of " << checker.steps.size() << " steps, "
+              << checker.checkedLemmas << " checked, " << checker.ratLemmas << " needed RAT" << std::endl;
+    std::cout << "c ignored deletions: " << checker.ignoredDeletions << std::endl;
+
+    if(verified && !corePath.empty()) {
+        std::ofstream out(corePath);
+        checker.writeCore(out);
+    }
+    if(verified && !trimmedPath.empty()) {
+        std::ofstream out(trimmedPath);
+        checker.writeTrimmed(out);
+    }
+    std::cout << (verified ? "VERIFIED" : "NOT VERIFIED") << std::endl;
+    return verified ? 0 : 1;
+}
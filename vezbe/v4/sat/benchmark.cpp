@@ -0,0 +1,517 @@
+// Pokretanje SAT resavaca nad skupom instanci i merenje vremena, memorije
+// i PAR-2 rezultata. Instance se generisu iz zadatog semena (uvek iste za
+// isto seme) ili citaju iz direktorijuma sa DIMACS fajlovima.
+//
+//   benchmark --solver=./sat [--gen=...]... [--dir=cnf/] [--timeout=60]
+//             [--memory=4096] [--seed=1] [--work=bench/] [--csv=out.csv]
+//             [--json=out.json] [--compare=old.csv] [-- opcije resavaca]
+//
+// Generatori (--gen=ime:parametri, moze vise puta):
+//   ksat:k:n:count      slucajni k-SAT na faznom prelazu
+//   php:holes           golubovi: holes + 1 goluba u holes rupa
+//   parity:length       brojac iz v5/brojac.cpp sa lancem zadate duzine
+//   color:n:colors:count bojenje slucajnog grafa sa n cvorova
+// Bez --gen i --dir pokrece se podrazumevani skup instanci.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <filesystem>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using Literal = int;
+using Clause = std::vector<Literal>;
+using NormalForm = std::vector<Clause>;
+
+struct Instance {
+    std::string name;
+    std::string family;
+    std::string path;
+};
+
+struct Run {
+    Instance instance;
+    std::string result;
+    double time = 0;
+    long peakRss = 0;
+    double par2 = 0;
+};
+
+void writeDimacs(const std::string& path, int atomCount, const NormalForm& formula) {
+    std::ofstream out(path);
+    out << "p cnf " << atomCount << " " << formula.size() << "\n";
+    for(const Clause& c : formula) {
+        for(Literal l : c)
+            out << l << " ";
+        out << "0\n";
+    }
+}
+
+// Odnos broja klauza i atoma na kome je slucajni k-SAT najtezi.
+double phaseTransition(int k) {
+    switch(k) {
+        case 2: return 1.0;
+        case 3: return 4.26;
+        case 4: return 9.93;
+        case 5: return 21.11;
+        case 6: return 43.37;
+        default: return 87.79;
+    }
+}
+
+NormalForm randomKSat(int k, int n, std::mt19937& rng) {
+    NormalForm formula;
+    int m = phaseTransition(k) * n + 0.5;
+    std::vector<int> atoms(n);
+    for(int i = 0; i < n; i++)
+        atoms[i] = i + 1;
+    for(int i = 0; i < m; i++) {
+        Clause c;
+        for(int j = 0; j < k; j++) {
+            std::swap(atoms[j], atoms[j + rng() % (n - j)]);
+            c.push_back(rng() % 2 ? atoms[j] : -atoms[j]);
+        }
+        formula.push_back(c);
+    }
+    return formula;
+}
+
+// Atom p(i, h): golub i je u rupi h.
+NormalForm pigeonhole(int holes) {
+    NormalForm formula;
+    auto p = [&](int i, int h) { return i * holes + h + 1; };
+    for(int i = 0; i <= holes; i++) {
+        Clause c;
+        for(int h = 0; h < holes; h++)
+            c.push_back(p(i, h));
+        formula.push_back(c);
+    }
+    for(int h = 0; h < holes; h++)
+        for(int i = 0; i <= holes; i++)
+            for(int j = i + 1; j <= holes; j++)
+                formula.push_back({-p(i, h), -p(j, h)});
+    return formula;
+}
+
+// Isto kodiranje kao u v5/brojac.cpp: R(i, i + 1) za svaki korak lanca i
+// nJ(0, length) na kraju.
+NormalForm parityChain(int length) {
+    NormalForm formula;
+    auto p = [](int i) { return 2 * i + 1; };
+    auto q = [](int i) { return 2 * i + 2; };
+    for(int i = 0; i < length; i++) {
+        formula.push_back({p(i), q(i), -p(i + 1)});
+        formula.push_back({p(i), -q(i), p(i + 1)});
+        formula.push_back({-p(i), q(i), p(i + 1)});
+        formula.push_back({-p(i), -q(i), -p(i + 1)});
+        formula.push_back({q(i), q(i + 1)});
+        formula.push_back({-q(i), -q(i + 1)});
+    }
+    int j = length;
+    formula.push_back({p(0), p(j), q(0), q(j)});
+    formula.push_back({-p(0), -p(j), q(0), q(j)});
+    formula.push_back({p(0), p(j), -q(0), -q(j)});
+    formula.push_back({-p(0), -p(j), -q(0), -q(j)});
+    return formula;
+}
+
+// Slucajni graf sa prosecnim stepenom blizu praga k-obojivosti. Atom
+// x(v, c): cvor v ima boju c.
+NormalForm graphColoring(int n, int colors, std::mt19937& rng) {
+    NormalForm formula;
+    auto x = [&](int v, int c) { return v * colors + c + 1; };
+    for(int v = 0; v < n; v++) {
+        Clause c;
+        for(int k = 0; k < colors; k++)
+            c.push_back(x(v, k));
+        formula.push_back(c);
+        for(int a = 0; a < colors; a++)
+            for(int b = a + 1; b < colors; b++)
+                formula.push_back({-x(v, a), -x(v, b)});
+    }
+    double degree = colors == 3 ? 4.69 : colors == 4 ? 8.9 : colors == 5 ? 13.69 : 2.0 * colors * std::log(colors);
+    int edges = degree * n / 2;
+    for(int e = 0; e < edges; e++) {
+        int u = rng() % n, v = rng() % n;
+        if(u == v)
+            continue;
+        for(int k = 0; k < colors; k++)
+            formula.push_back({-x(u, k), -x(v, k)});
+    }
+    return formula;
+}
+
+std::vector<int> parameters(const std::string& spec) {
+    std::vector<int> values;
+    std::stringstream in(spec);
+    std::string part;
+    while(std::getline(in, part, ':'))
+        values.push_back(std::stoi(part));
+    return values;
+}
+
+// Generise instance opisane sa ime:parametri u direktorijum work. Seme se
+// racuna iz semena pokretanja i imena instance, pa ista instanca ne zavisi
+// od redosleda generatora.
+bool generate(const std::string& spec, unsigned seed, const std::string& work, std::vector<Instance>& instances) {
+    std::string family = spec.substr(0, spec.find(':'));
+    std::vector<int> args = spec.find(':') == std::string::npos
+        ? std::vector<int>()
+        : parameters(spec.substr(spec.find(':') + 1));
+    auto add = [&](const std::string& name, int atomCount, const NormalForm& formula) {
+        std::string path = work + "/" + name + ".cnf";
+        writeDimacs(path, atomCount, formula);
+        instances.push_back({name, family, path});
+    };
+    auto rngFor = [&](const std::string& name) {
+        std::vector<unsigned> data(name.begin(), name.end());
+        data.push_back(seed);
+        std::seed_seq seq(data.begin(), data.end());
+        return std::mt19937(seq);
+    };
+
+    // Klauza bira k razlicitih od n atoma, pa mora biti 1 <= k <= n.
+    if(family == "ksat" && args.size() == 3 && args[0] >= 1 && args[0] <= args[1]) {
+        for(int i = 0; i < args[2]; i++) {
+            std::string name = "ksat-" + std::to_string(args[0]) + "-" + std::to_string(args[1]) + "-" + std::to_string(i);
+            std::mt19937 rng = rngFor(name);
+            add(name, args[1], randomKSat(args[0], args[1], rng));
+        }
+    }
+    else if(family == "php" && args.size() == 1)
+        add("php-" + std::to_string(args[0]), (args[0] + 1) * args[0], pigeonhole(args[0]));
+    else if(family == "parity" && args.size() == 1)
+        add("parity-" + std::to_string(args[0]), 2 * args[0] + 2, parityChain(args[0]));
+    else if(family == "color" && args.size() == 3) {
+        for(int i = 0; i < args[2]; i++) {
+            std::string name = "color-" + std::to_string(args[0]) + "-" + std::to_string(args[1]) + "-" + std::to_string(i);
+            std::mt19937 rng = rngFor(name);
+            add(name, args[0] * args[1], graphColoring(args[0], args[1], rng));
+        }
+    }
+    else
+        return false;
+    return true;
+}
+
+void loadDirectory(const std::string& dir, std::vector<Instance>& instances) {
+    std::vector<std::filesystem::path> paths;
+    for(const auto& entry : std::filesystem::recursive_directory_iterator(dir))
+        if(entry.is_regular_file() && entry.path().extension() == ".cnf")
+            paths.push_back(entry.path());
+    std::sort(begin(paths), end(paths));
+    for(const auto& path : paths)
+        instances.push_back({path.stem().string(), path.parent_path().filename().string(), path.string()});
+}
+
+// Pokrece resavac nad instancom u posebnom procesu. Memorija se ogranicava
+// sa RLIMIT_AS, a proces koji predje vremensko ogranicenje se ubija.
+// Vrsno zauzece memorije je ru_maxrss deteta.
+Run run(const Instance& instance, const std::vector<std::string>& command, double timeout, long memoryMb) {
+    Run result;
+    result.instance = instance;
+    char output[] = "/tmp/benchmark-XXXXXX";
+    char errors[] = "/tmp/benchmark-XXXXXX";
+    int fd = mkstemp(output);
+    int errorFd = fd < 0 ? -1 : mkstemp(errors);
+    auto cleanup = [&] {
+        if(fd >= 0) {
+            ::close(fd);
+            unlink(output);
+        }
+        if(errorFd >= 0) {
+            ::close(errorFd);
+            unlink(errors);
+        }
+    };
+    if(errorFd < 0) {
+        cleanup();
+        result.result = "ERROR";
+        return result;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if(pid < 0) {
+        cleanup();
+        result.result = "ERROR";
+        return result;
+    }
+    if(pid == 0) {
+        dup2(fd, STDOUT_FILENO);
+        dup2(errorFd, STDERR_FILENO);
+        ::close(fd);
+        ::close(errorFd);
+        if(memoryMb > 0) {
+            struct rlimit limit;
+            limit.rlim_cur = limit.rlim_max = (rlim_t)memoryMb << 20;
+            setrlimit(RLIMIT_AS, &limit);
+        }
+        std::vector<char*> argv;
+        for(const std::string& arg : command)
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        argv.push_back(const_cast<char*>(instance.path.c_str()));
+        argv.push_back(nullptr);
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+
+    // Prekinut wait4 (EINTR) se ponavlja; bez uspesnog wait4 status i
+    // usage nisu popunjeni, pa je rezultat ERROR.
+    int status = 0;
+    struct rusage usage = {};
+    bool timedOut = false, waited = false;
+    while(true) {
+        pid_t done = wait4(pid, &status, WNOHANG, &usage);
+        if(done < 0 && errno == EINTR)
+            continue;
+        if(done != 0) {
+            waited = done == pid;
+            break;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if(elapsed.count() > timeout) {
+            kill(pid, SIGKILL);
+            while((done = wait4(pid, &status, 0, &usage)) < 0 && errno == EINTR)
+                ;
+            waited = done == pid;
+            timedOut = true;
+            break;
+        }
+        usleep(1000);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    result.time = elapsed.count();
+    result.peakRss = usage.ru_maxrss;
+
+    std::ifstream in(output);
+    std::string line, last;
+    while(std::getline(in, line))
+        if(line == "SAT" || line == "UNSAT" || line == "UNKNOWN")
+            last = line;
+    // Proces kome je ponestalo memorije se obicno zavrsi sa std::bad_alloc
+    // (SIGABRT) ili porukom o neuspeloj alokaciji; ostali signali, npr.
+    // SIGSEGV, su greske.
+    std::ifstream errorsIn(errors);
+    bool allocationFailed = false;
+    while(std::getline(errorsIn, line))
+        allocationFailed = allocationFailed || line.find("bad_alloc") != std::string::npos
+            || line.find("Cannot allocate memory") != std::string::npos
+            || line.find("out of memory") != std::string::npos;
+    cleanup();
+
+    if(!waited)
+        result.result = "ERROR";
+    else if(timedOut)
+        result.result = "TIMEOUT";
+    else if(WIFEXITED(status) && WEXITSTATUS(status) == 0 && !last.empty())
+        result.result = last;
+    else if(memoryMb > 0 && allocationFailed)
+        result.result = "MEMOUT";
+    else
+        result.result = "ERROR";
+    bool solved = result.result == "SAT" || result.result == "UNSAT";
+    result.par2 = solved ? result.time : 2 * timeout;
+    return result;
+}
+
+// CSV polje pod navodnicima; navodnik se udvaja.
+std::string csvField(const std::string& text) {
+    std::string quoted = "\"";
+    for(char c : text) {
+        if(c == '"')
+            quoted += '"';
+        quoted += c;
+    }
+    return quoted + '"';
+}
+
+// Polja jednog CSV reda; zarez i udvojen navodnik unutar navodnika su
+// deo polja.
+std::vector<std::string> csvFields(const std::string& line) {
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for(size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if(quoted && c == '"' && i + 1 < line.size() && line[i + 1] == '"')
+            fields.back() += line[++i];
+        else if(c == '"')
+            quoted = !quoted;
+        else if(c == ',' && !quoted)
+            fields.emplace_back();
+        else
+            fields.back() += c;
+    }
+    return fields;
+}
+
+void writeCsv(std::ostream& out, const std::vector<Run>& runs) {
+    out << "instance,family,result,time,peak_rss_kb,par2\n";
+    for(const Run& r : runs)
+        out << csvField(r.instance.name) << "," << csvField(r.instance.family) << "," << r.result << ","
+            << r.time << "," << r.peakRss << "," << r.par2 << "\n";
+}
+
+// JSON string sa navodnicima; \" i \\ se zapisuju sa kosom crtom, a
+// kontrolni znakovi kao \u00XX.
+std::string jsonString(const std::string& text) {
+    std::string quoted = "\"";
+    for(char c : text) {
+        if(c == '"' || c == '\\')
+            quoted += '\\';
+        if((unsigned char)c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof escaped, "\\u%04x", c);
+            quoted += escaped;
+        }
+        else
+            quoted += c;
+    }
+    return quoted + '"';
+}
+
+void writeJson(std::ostream& out, const std::vector<Run>& runs, double timeout, unsigned seed) {
+    double par2 = 0;
+    int solved = 0;
+    for(const Run& r : runs) {
+        par2 += r.par2;
+        solved += r.result == "SAT" || r.result == "UNSAT";
+    }
+    out << "{\"timeout\": " << timeout << ", \"seed\": " << seed << ", \"solved\": " << solved
+        << ", \"par2\": " << par2 << ", \"instances\": [";
+    for(size_t i = 0; i < runs.size(); i++) {
+        const Run& r = runs[i];
+        out << (i ? ", " : "") << "{\"instance\": " << jsonString(r.instance.name) << ", \"family\": "
+            << jsonString(r.instance.family) << ", \"result\": \"" << r.result << "\", \"time\": " << r.time
+            << ", \"peak_rss_kb\": " << r.peakRss << ", \"par2\": " << r.par2 << "}";
+    }
+    out << "]}" << std::endl;
+}
+
+// Poredi PAR-2 sa ranijim CSV izvestajem: ispisuje instance koje su sada
+// bar dvostruko sporije ili vise nisu resene, kao i ukupan PAR-2 oba
+// pokretanja nad zajednickim instancama.
+void compare(const std::string& path, const std::vector<Run>& runs) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    std::vector<std::pair<std::string, double>> old;
+    while(std::getline(in, line)) {
+        std::vector<std::string> fields = csvFields(line);
+        if(fields.size() == 6)
+            old.push_back({fields[0], std::stod(fields[5])});
+    }
+
+    double before = 0, after = 0;
+    for(const Run& r : runs) {
+        auto it = std::find_if(begin(old), end(old), [&](const auto& o) { return o.first == r.instance.name; });
+        if(it == end(old))
+            continue;
+        before += it->second;
+        after += r.par2;
+        if(r.par2 > 2 * it->second && r.par2 - it->second > 0.1)
+            std::cout << "regression: " << r.instance.name << " " << it->second << " s -> " << r.par2 << " s" << std::endl;
+    }
+    std::cout << "PAR-2: " << before << " -> " << after << std::endl;
+}
+
+// Za argument oblika --name=value upisuje value i vraca true.
+bool option(const std::string& arg, const std::string& name, std::string& value) {
+    if(arg.compare(0, name.size() + 1, name + "=") != 0)
+        return false;
+    value = arg.substr(name.size() + 1);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string solver = "./sat", work = "bench", csvPath, jsonPath, comparePath;
+    std::vector<std::string> generators, dirs, solverArgs;
+    double timeout = 60;
+    long memoryMb = 0;
+    unsigned seed = 1;
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i], value;
+        if(arg == "--") {
+            solverArgs.assign(argv + i + 1, argv + argc);
+            break;
+        }
+        else if(option(arg, "--solver", value))
+            solver = value;
+        else if(option(arg, "--gen", value))
+            generators.push_back(value);
+        else if(option(arg, "--dir", value))
+            dirs.push_back(value);
+        else if(option(arg, "--timeout", value))
+            timeout = std::stod(value);
+        else if(option(arg, "--memory", value))
+            memoryMb = std::stol(value);
+        else if(option(arg, "--seed", value))
+            seed = std::stoul(value);
+        else if(option(arg, "--work", value))
+            work = value;
+        else if(option(arg, "--csv", value))
+            csvPath = value;
+        else if(option(arg, "--json", value))
+            jsonPath = value;
+        else if(option(arg, "--compare", value))
+            comparePath = value;
+        else {
+            std::cerr << "Nepoznata opcija: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if(generators.empty() && dirs.empty())
+        generators = {"ksat:3:150:5", "ksat:3:200:5", "ksat:5:50:3", "php:7", "php:8", "php:9",
+                      "parity:64", "parity:1024", "color:150:3:3", "color:100:4:3"};
+
+    std::filesystem::create_directories(work);
+    std::vector<Instance> instances;
+    for(const std::string& spec : generators) {
+        if(!generate(spec, seed, work, instances)) {
+            std::cerr << "Nepoznat generator ili neispravni parametri: " << spec << std::endl;
+            return 1;
+        }
+    }
+    for(const std::string& dir : dirs)
+        loadDirectory(dir, instances);
+
+    std::vector<std::string> command{solver};
+    command.insert(command.end(), solverArgs.begin(), solverArgs.end());
+    std::vector<Run> runs;
+    for(const Instance& instance : instances) {
+        runs.push_back(run(instance, command, timeout, memoryMb));
+        const Run& r = runs.back();
+        std::cout << r.instance.name << " " << r.result << " " << r.time << " s " << r.peakRss << " KB" << std::endl;
+    }
+
+    if(!csvPath.empty()) {
+        std::ofstream out(csvPath);
+        writeCsv(out, runs);
+    }
+    if(!jsonPath.empty()) {
+        std::ofstream out(jsonPath);
+        writeJson(out, runs, timeout, seed);
+    }
+    if(!comparePath.empty())
+        compare(comparePath, runs);
+    else {
+        double par2 = 0;
+        for(const Run& r : runs)
+            par2 += r.par2;
+        std::cout << "PAR-2: " << par2 << std::endl;
+    }
+
+    return 0;
+}
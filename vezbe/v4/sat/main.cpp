@@ -1,159 +1,3516 @@
 #include <iostream>
+#include <fstream>
+#include <string>
 #include <vector>
-#include <map>
 #include <optional>
+#include <algorithm>
+#include <memory>
+#include <deque>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <climits>
+#include <random>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using Atom = int;
 using Literal = int;
 using Clause = std::vector<Literal>;
 using NormalForm = std::vector<Clause>;
 
+// Unutar resavaca literal je 2 * atom za pozitivan, odnosno 2 * atom + 1 za
+// negiran literal, pa je negacija l ^ 1, a literal moze da indeksira niz.
+using Lit = uint32_t;
+using ClauseRef = uint32_t;
+const ClauseRef NoClause = UINT32_MAX;
+
+Lit toLit(Literal l) { return l > 0 ? 2u * l : 2u * -l + 1; }
+Literal toLiteral(Lit l) { return l & 1 ? -(Literal)(l >> 1) : (Literal)(l >> 1); }
+Atom atomOf(Lit l) { return l >> 1; }
+
+// Sve klauze su u jednom nizu 32-bitnih reci. Klauza pocinje zaglavljem od
+// tri reci (broj literala, zastavice i LBD, aktivnost), iza kog slede
+// literali, i adresira se pomerajem svog zaglavlja u nizu.
+struct ClauseArena {
+    enum Flag : uint32_t { Learnt = 1, Deleted = 2, Used = 4, Relocated = 8, Vivified = 16 };
+    static const uint32_t HeaderSize = 3;
+
+    std::vector<uint32_t> memory;
+    size_t wasted = 0;
+
+    ClauseRef add(const Lit* lits, uint32_t size, bool learnt = false, uint32_t lbd = 0) {
+        ClauseRef c = memory.size();
+        memory.push_back(size);
+        memory.push_back(lbd << 5 | (learnt ? uint32_t(Learnt) : 0u));
+        memory.push_back(0);
+        memory.insert(memory.end(), lits, lits + size);
+        return c;
+    }
+
+    ClauseRef addClause(const Clause& clause) {
+        ClauseRef c = add(nullptr, 0);
+        for(Literal l : clause)
+            memory.push_back(toLit(l));
+        memory[c] = clause.size();
+        return c;
+    }
+
+    uint32_t size(ClauseRef c) const { return memory[c]; }
+    Lit* begin(ClauseRef c) { return memory.data() + c + HeaderSize; }
+    Lit* end(ClauseRef c) { return begin(c) + size(c); }
+    const Lit* begin(ClauseRef c) const { return memory.data() + c + HeaderSize; }
+    const Lit* end(ClauseRef c) const { return begin(c) + size(c); }
+    Lit& operator()(ClauseRef c, uint32_t i) { return memory[c + HeaderSize + i]; }
+
+    bool has(ClauseRef c, Flag flag) const { return memory[c + 1] & flag; }
+    void set(ClauseRef c, Flag flag) { memory[c + 1] |= flag; }
+    void clear(ClauseRef c, Flag flag) { memory[c + 1] &= ~flag; }
+
+    uint32_t lbd(ClauseRef c) const { return memory[c + 1] >> 5; }
+    void setLbd(ClauseRef c, uint32_t lbd) { memory[c + 1] = (memory[c + 1] & 31) | lbd << 5; }
+
+    float activity(ClauseRef c) const {
+        float a;
+        std::memcpy(&a, &memory[c + 2], sizeof a);
+        return a;
+    }
+    void setActivity(ClauseRef c, float a) { std::memcpy(&memory[c + 2], &a, sizeof a); }
+
+    // Skracuje klauzu na prvih size literala.
+    void shrink(ClauseRef c, uint32_t size) {
+        wasted += memory[c] - size;
+        memory[c] = size;
+    }
+
+    void remove(ClauseRef c) {
+        set(c, Deleted);
+        wasted += HeaderSize + size(c);
+    }
+
+    // Kopira klauzu u arenu to i u staroj ostavlja njenu novu adresu, tako
+    // da se svaka klauza premesti samo jednom bez obzira na broj referenci.
+    ClauseRef relocate(ClauseRef c, ClauseArena& to) {
+        if(has(c, Relocated))
+            return memory[c + 2];
+        ClauseRef moved = to.memory.size();
+        to.memory.insert(to.memory.end(), memory.begin() + c, memory.begin() + c + HeaderSize + size(c));
+        set(c, Relocated);
+        memory[c + 2] = moved;
+        return moved;
+    }
+};
+
+// Heuristika koja bira sledeci atom za odluku.
+struct BranchingHeuristic {
+    virtual ~BranchingHeuristic() = default;
+    virtual void init(int atomCount) = 0;
+    // Dodaje atome do atomCount, bez menjanja stanja postojecih.
+    virtual void grow(int atomCount) = 0;
+    // Atom je ucestvovao u analizi konflikta.
+    virtual void bump(Atom) {}
+    // Poziva se jednom po konfliktu.
+    virtual void decay() {}
+    // Atom je ponovo nedodeljen nakon bektrekinga.
+    virtual void unassigned(Atom atom) = 0;
+    // Vraca nedodeljen atom ili 0 ako su svi atomi dodeljeni.
+    virtual Atom pick(const std::vector<signed char>& value) = 0;
+    // Da li bi atom a bio izabran pre atoma b.
+    virtual bool prefers(Atom a, Atom b) const = 0;
+};
+
+// Atomi redom od 1 navise.
+struct LinearHeuristic : BranchingHeuristic {
+    int atomCount = 0;
+    Atom next = 1;
+
+    void init(int n) override {
+        atomCount = n;
+        next = 1;
+    }
+
+    void grow(int n) override {
+        atomCount = n;
+    }
+
+    void unassigned(Atom atom) override {
+        next = std::min(next, atom);
+    }
+
+    Atom pick(const std::vector<signed char>& value) override {
+        while(next <= atomCount && value[next] != 0)
+            next++;
+        return next <= atomCount ? next : 0;
+    }
+
+    bool prefers(Atom a, Atom b) const override {
+        return a < b;
+    }
+};
+
+// EVSIDS: svaki atom iz analize konflikta dobija increment, a increment
+// posle svakog konflikta raste za 1/decayFactor, pa skoriji konflikti
+// vise vrede. Atomi su u binarnom hipu uredjenom po aktivnosti.
+struct VsidsHeuristic : BranchingHeuristic {
+    double decayFactor;
+    double increment = 1;
+    std::vector<double> activity;
+    std::vector<Atom> heap;
+    std::vector<int> position;
+    // Ako je seed razlicit od 0, pocetne aktivnosti su male slucajne
+    // vrednosti, pa razlicite niti u portfoliju biraju razlicite atome.
+    unsigned seed;
+
+    explicit VsidsHeuristic(double decayFactor = 0.95, unsigned seed = 0) : decayFactor(decayFactor), seed(seed) {}
+
+    void up(int i) {
+        Atom atom = heap[i];
+        while(i > 0 && activity[heap[(i - 1) / 2]] < activity[atom]) {
+            heap[i] = heap[(i - 1) / 2];
+            position[heap[i]] = i;
+            i = (i - 1) / 2;
+        }
+        heap[i] = atom;
+        position[atom] = i;
+    }
+
+    void down(int i) {
+        Atom atom = heap[i];
+        int n = heap.size();
+        while(2 * i + 1 < n) {
+            int child = 2 * i + 1;
+            if(child + 1 < n && activity[heap[child + 1]] > activity[heap[child]])
+                child++;
+            if(activity[heap[child]] <= activity[atom])
+                break;
+            heap[i] = heap[child];
+            position[heap[i]] = i;
+            i = child;
+        }
+        heap[i] = atom;
+        position[atom] = i;
+    }
+
+    void insert(Atom atom) {
+        if(position[atom] != -1)
+            return;
+        heap.push_back(atom);
+        up(heap.size() - 1);
+    }
+
+    Atom removeMax() {
+        Atom top = heap[0];
+        position[top] = -1;
+        heap[0] = heap.back();
+        heap.pop_back();
+        if(!heap.empty())
+            down(0);
+        return top;
+    }
+
+    void init(int atomCount) override {
+        activity.assign(atomCount + 1, 0);
+        position.assign(atomCount + 1, -1);
+        heap.clear();
+        if(seed != 0) {
+            std::mt19937 rng(seed);
+            std::uniform_real_distribution<double> noise(0, 1e-5);
+            for(Atom atom = 1; atom <= atomCount; atom++)
+                activity[atom] = noise(rng);
+        }
+        for(Atom atom = 1; atom <= atomCount; atom++)
+            insert(atom);
+    }
+
+    void grow(int atomCount) override {
+        int old = activity.size();
+        activity.resize(atomCount + 1, 0);
+        position.resize(atomCount + 1, -1);
+        for(Atom atom = old; atom <= atomCount; atom++)
+            insert(atom);
+    }
+
+    void bump(Atom atom) override {
+        if((activity[atom] += increment) > 1e100) {
+            for(double& a : activity)
+                a *= 1e-100;
+            increment *= 1e-100;
+        }
+        if(position[atom] != -1)
+            up(position[atom]);
+    }
+
+    void decay() override {
+        increment /= decayFactor;
+    }
+
+    void unassigned(Atom atom) override {
+        insert(atom);
+    }
+
+    Atom pick(const std::vector<signed char>& value) override {
+        while(!heap.empty()) {
+            Atom atom = removeMax();
+            if(value[atom] == 0)
+                return atom;
+        }
+        return 0;
+    }
+
+    bool prefers(Atom a, Atom b) const override {
+        return activity[a] > activity[b];
+    }
+};
+
+// i-ti clan (od 0) Luby niza 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ...
+long long luby(long long i) {
+    long long size = 1;
+    int seq = 0;
+    while(size < i + 1) {
+        seq++;
+        size = 2 * size + 1;
+    }
+    while(size - 1 != i) {
+        size = (size - 1) / 2;
+        seq--;
+        i = i % size;
+    }
+    return 1LL << seq;
+}
+
+// Politika koja odlucuje kada se pretraga restartuje.
+struct RestartPolicy {
+    virtual ~RestartPolicy() = default;
+    // Poziva se posle svakog konflikta sa LBD naucene klauze i velicinom steka.
+    virtual void conflict(int lbd, size_t trailSize) = 0;
+    virtual bool shouldRestart() const = 0;
+    virtual void restarted() = 0;
+};
+
+struct NoRestarts : RestartPolicy {
+    void conflict(int, size_t) override {}
+    bool shouldRestart() const override { return false; }
+    void restarted() override {}
+};
+
+// Restart posle unit * luby(i) konflikata.
+struct LubyRestarts : RestartPolicy {
+    long long unit;
+    long long count = 0;
+    long long conflicts = 0;
+
+    explicit LubyRestarts(long long unit) : unit(unit) {}
+
+    void conflict(int, size_t) override {
+        conflicts++;
+    }
+
+    bool shouldRestart() const override {
+        return conflicts >= unit * luby(count);
+    }
+
+    void restarted() override {
+        count++;
+        conflicts = 0;
+    }
+};
+
+// Restart kada je prosecan LBD poslednjih `window` konflikata za faktor
+// 1/k losiji od proseka svih konflikata. Restart se blokira ako je stek
+// znatno duzi nego obicno, jer je resenje mozda blizu.
+struct GlucoseRestarts : RestartPolicy {
+    double k;
+    size_t window;
+    double blockFactor;
+    size_t blockWindow;
+    std::deque<int> recentLbd;
+    long long recentLbdSum = 0;
+    std::deque<size_t> recentTrail;
+    long long recentTrailSum = 0;
+    double lbdSum = 0;
+    long long conflicts = 0;
+
+    GlucoseRestarts(double k, size_t window, double blockFactor = 1.4, size_t blockWindow = 5000)
+        : k(k), window(window), blockFactor(blockFactor), blockWindow(blockWindow) {}
+
+    void conflict(int lbd, size_t trailSize) override {
+        conflicts++;
+        lbdSum += lbd;
+
+        recentTrail.push_back(trailSize);
+        recentTrailSum += trailSize;
+        if(recentTrail.size() > blockWindow) {
+            recentTrailSum -= recentTrail.front();
+            recentTrail.pop_front();
+        }
+        if(conflicts > 10000 && recentLbd.size() == window && recentTrail.size() == blockWindow
+           && trailSize > blockFactor * recentTrailSum / blockWindow)
+            restarted();
+
+        recentLbd.push_back(lbd);
+        recentLbdSum += lbd;
+        if(recentLbd.size() > window) {
+            recentLbdSum -= recentLbd.front();
+            recentLbd.pop_front();
+        }
+    }
+
+    bool shouldRestart() const override {
+        return recentLbd.size() == window
+            && (double)recentLbdSum / window * k > lbdSum / conflicts;
+    }
+
+    void restarted() override {
+        recentLbd.clear();
+        recentLbdSum = 0;
+    }
+};
+
+struct Statistics {
+    long long decisions = 0;
+    long long propagations = 0;
+    long long conflicts = 0;
+    long long restarts = 0;
+    long long learnt = 0;
+    long long deleted = 0;
+    long long reductions = 0;
+    long long preprocessRemovedClauses = 0;
+    long long preprocessEliminatedAtoms = 0;
+    double preprocessTime = 0;
+    long long exported = 0;
+    long long imported = 0;
+    long long cubes = 0;
+    long long cubesRefuted = 0;
+    double cubeTime = 0;
+    // Inprocesiranje: broj pokretanja, pa za svaku tehniku koliko je
+    // uklonila i koliko je trajala.
+    long long inprocessings = 0;
+    long long failedLiterals = 0;
+    long long vivifiedClauses = 0;
+    long long vivifiedLiterals = 0;
+    long long substitutedAtoms = 0;
+    double probeTime = 0;
+    double vivifyTime = 0;
+    double substituteTime = 0;
+    // XOR ogranicenja u matricama, broj matrica i broj propagacija i
+    // konflikata koje je nasla eliminacija.
+    long long xorConstraints = 0;
+    long long xorMatrices = 0;
+    long long xorPropagations = 0;
+    long long xorConflicts = 0;
+    // Lokalna pretraga: broj pokretanja, ukupan broj promena atoma i
+    // najmanji broj nezadovoljenih klauza u poslednjem pokretanju.
+    long long localSearches = 0;
+    long long localFlips = 0;
+    long long localBestUnsat = 0;
+    double localTime = 0;
+    // Vreme u sekundama. Vreme propagacije, analize konflikata i ciscenja
+    // baze se meri samo kada je program preveden sa -DSAT_PROFILE.
+    double searchTime = 0;
+    double propagateTime = 0;
+    double analyzeTime = 0;
+    double reduceTime = 0;
+};
+
+// Dodaje vreme od konstrukcije do kraja opsega na zadati brojac. Bez
+// SAT_PROFILE nema nikakav efekat, pa ni cenu u propagaciji.
+struct PhaseTimer {
+#ifdef SAT_PROFILE
+    double& total;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    explicit PhaseTimer(double& total) : total(total) {}
+    ~PhaseTimer() {
+        std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        total += time.count();
+    }
+#else
+    explicit PhaseTimer(double&) {}
+#endif
+};
+
+// Naucene klauze su u istoj areni kao i originalne, a LBD, aktivnost i
+// oznaka da je klauza skoro koriscena su u zaglavlju klauze. Klauze sa
+// LBD <= coreLbd se nikad ne brisu, one sa LBD <= tier2Lbd ostaju dok god
+// se koriste, a od ostalih se pri svakom ciscenju brise polovina sa
+// najmanjom aktivnoscu.
+struct ClauseDatabase {
+    float increment = 1;
+    float decayFactor = 0.999f;
+    uint32_t coreLbd = 2;
+    uint32_t tier2Lbd = 6;
+    long long reduceFirst = 2000;
+    long long reduceIncrement = 300;
+    long long nextReduce = 2000;
+    bool reduce = true;
+
+    void bump(ClauseArena& arena, const std::vector<ClauseRef>& learnts, ClauseRef c) {
+        arena.set(c, ClauseArena::Used);
+        arena.setActivity(c, arena.activity(c) + increment);
+        if(arena.activity(c) > 1e20f) {
+            for(ClauseRef d : learnts)
+                arena.setActivity(d, arena.activity(d) * 1e-20f);
+            increment *= 1e-20f;
+        }
+    }
+
+    void decay() {
+        increment /= decayFactor;
+    }
+};
+
+// Raspored inprocesiranja: prvi put posle interval konflikata, a svaki
+// sledeci put posle jos interval konflikata vise nego prethodni. Probanje
+// i vivifikacija smeju da potrose effort puta onoliko propagacija koliko je
+// pretraga potrosila od prethodnog inprocesiranja.
+struct Inprocessing {
+    bool enabled = true;
+    bool substitute = true;
+    long long interval = 2000;
+    long long next = 2000;
+    double effort = 0.1;
+    long long propagations = 0;
+    // Probanje i vivifikacija originalnih klauza nastavljaju tamo gde je
+    // prethodno pokretanje stalo.
+    size_t probeCursor = 0;
+    size_t vivifyCursor = 0;
+    // Parovi (atom kao pozitivan literal, literal kojim je zamenjen),
+    // redom kojim su zamene uradjene.
+    std::vector<Lit> substituted;
+};
+
+// XOR ogranicenje: XOR atoma je rhs. Ogranicenja nadjena u formuli su i
+// dalje zapisana klauzama, a nativna (dodata kroz Solver) nisu, pa se
+// nativna ogranicenja uvek eliminisu.
+struct Xor {
+    std::vector<Atom> atoms;
+    bool rhs;
+    bool native;
+};
+
+// Matrica jedne komponente XOR ogranicenja nad GF(2). Red je niz 64-bitnih
+// reci sa po jednim bitom za svaku kolonu (atom), pa se redovi sabiraju rec
+// po rec. Matrica je svedena: svaki red ima baznu kolonu koje nema ni u
+// jednom drugom redu, a red prati baznu i jos jednu kolonu, kao klauza
+// dva literala. Dok red nije ceo dodeljen, bazna kolona mu je nedodeljena;
+// kada se ona dodeli, bazna postaje neka druga nedodeljena kolona reda i
+// izbacuje se iz ostalih redova.
+struct XorMatrix {
+    size_t words = 0;
+    std::vector<Atom> atoms;
+    std::vector<uint64_t> bits;
+    std::vector<char> rhs;
+    std::vector<int> basic;
+    std::vector<int> watch;
+    // Za svaku kolonu redovi koji je prate (moze biti zastarelih unosa) i
+    // bitovi dodeljenih i tacnih kolona.
+    std::vector<std::vector<int>> watches;
+    std::vector<uint64_t> assigned;
+    std::vector<uint64_t> positive;
+    std::vector<long long> rowStamp;
+    long long stamp = 0;
+
+    size_t rows() const { return rhs.size(); }
+    bool has(int r, int col) const { return bits[r * words + col / 64] >> (col % 64) & 1; }
+    bool isAssigned(int col) const { return assigned[col / 64] >> (col % 64) & 1; }
+
+    void assign(int col, bool value) {
+        assigned[col / 64] |= uint64_t(1) << (col % 64);
+        if(value)
+            positive[col / 64] |= uint64_t(1) << (col % 64);
+    }
+
+    void unassign(int col) {
+        assigned[col / 64] &= ~(uint64_t(1) << (col % 64));
+        positive[col / 64] &= ~(uint64_t(1) << (col % 64));
+    }
+
+    void addRow(int to, int from) {
+        uint64_t* a = &bits[to * words];
+        const uint64_t* b = &bits[from * words];
+        for(size_t w = 0; w < words; w++)
+            a[w] ^= b[w];
+        rhs[to] ^= rhs[from];
+    }
+
+    // Prva kolona reda r (samo medju nedodeljenim ako je free) razlicita od
+    // except, ili -1.
+    int column(int r, bool free, int except = -1) const {
+        const uint64_t* row = &bits[r * words];
+        for(size_t w = 0; w < words; w++) {
+            uint64_t set = free ? row[w] & ~assigned[w] : row[w];
+            while(set) {
+                int col = w * 64 + __builtin_ctzll(set);
+                if(col != except)
+                    return col;
+                set &= set - 1;
+            }
+        }
+        return -1;
+    }
+
+    // Desna strana reda r sabrana sa tacnim kolonama: vrednost koju mora
+    // imati jedina nedodeljena kolona, a za ceo dodeljen red 1 znaci da
+    // red nije zadovoljen.
+    bool parity(int r) const {
+        const uint64_t* row = &bits[r * words];
+        int ones = rhs[r];
+        for(size_t w = 0; w < words; w++)
+            ones += __builtin_popcountll(row[w] & positive[w]);
+        return ones & 1;
+    }
+
+    // Gaus-Zordanova eliminacija: svaki red dobija baznu kolonu koja se
+    // izbacuje iz svih ostalih redova, a redovi 0 = 0 se brisu. Vraca false
+    // ako neki red postane 0 = 1.
+    bool eliminate() {
+        basic.assign(rows(), -1);
+        for(size_t r = 0; r < rows(); r++) {
+            int c = column(r, false);
+            if(c == -1) {
+                if(rhs[r])
+                    return false;
+                continue;
+            }
+            basic[r] = c;
+            for(size_t s = 0; s < rows(); s++)
+                if(s != r && has(s, c))
+                    addRow(s, r);
+        }
+        size_t k = 0;
+        for(size_t r = 0; r < rows(); r++) {
+            if(basic[r] == -1)
+                continue;
+            std::copy(&bits[r * words], &bits[(r + 1) * words], &bits[k * words]);
+            rhs[k] = rhs[r];
+            basic[k++] = basic[r];
+        }
+        bits.resize(k * words);
+        rhs.resize(k);
+        basic.resize(k);
+        watch.assign(k, -1);
+        rowStamp.assign(k, 0);
+        return true;
+    }
+};
+
+// XOR ogranicenja i njihove matrice. Matrica se gradi za svaku komponentu
+// atoma povezanih zajednickim ogranicenjima; prevelike komponente nadjene
+// u formuli ostaju samo klauze.
+struct Gauss {
+    std::vector<Xor> xors;
+    // Ogranicenja su dodata posle poslednje izgradnje matrica.
+    bool dirty = false;
+    size_t maxRows = 2048;
+    size_t maxColumns = 2048;
+    std::vector<XorMatrix> matrices;
+    std::vector<int> matrixOf;
+    std::vector<int> columnOf;
+    // Klauze koje su razlozi XOR propagacija i konflikata, redom kojim su
+    // napravljene. Klauza se brise kada joj se pri bektrekingu ponisti
+    // prvi literal.
+    std::vector<ClauseRef> reasons;
+    // Redovi koje je pivotiranje promenilo, pa im treba popraviti pracenje.
+    std::vector<int> pending;
+    std::vector<int> rows;
+    std::vector<Lit> lits;
+};
+
+// DRAT dokaz: niz dodatih i obrisanih klauza koji se zavrsava praznom
+// klauzom. U binarnom formatu klauza je bajt 'a' ili 'd', pa literali kao
+// varint brojevi 2 * atom + znak (isto kao interni Lit) i na kraju 0.
+// Bafer se po popunjavanju predaje pozadinskoj niti koja ga upisuje, a
+// resavac nastavlja u drugi bafer.
+struct ProofWriter {
+    static const size_t BufferSize = 1 << 22;
+
+    FILE* file;
+    bool pipe;
+    bool binary;
+    std::vector<unsigned char> buffer;
+    std::vector<unsigned char> pending;
+    bool busy = false;
+    bool done = false;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::thread writer;
+
+    // Fajl (ili imenovana cev) na putanji path, odnosno standardni ulaz
+    // komande path ako je pipe true.
+    ProofWriter(const std::string& path, bool pipe, bool binary)
+        : file(pipe ? popen(path.c_str(), "w") : std::fopen(path.c_str(), "wb")), pipe(pipe), binary(binary) {
+        buffer.reserve(BufferSize + 1024);
+        pending.reserve(BufferSize + 1024);
+        writer = std::thread([this]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while(true) {
+                changed.wait(lock, [&]() { return busy || done; });
+                if(!busy)
+                    return;
+                lock.unlock();
+                if(file)
+                    std::fwrite(pending.data(), 1, pending.size(), file);
+                pending.clear();
+                lock.lock();
+                busy = false;
+                changed.notify_all();
+            }
+        });
+    }
+
+    ~ProofWriter() {
+        flush();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        changed.notify_all();
+        writer.join();
+        if(file && pipe)
+            pclose(file);
+        else if(file)
+            std::fclose(file);
+    }
+
+    bool ok() const {
+        return file != nullptr;
+    }
+
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&]() { return !busy; });
+        std::swap(buffer, pending);
+        busy = true;
+        changed.notify_all();
+    }
+
+    void write(char kind, const Lit* first, const Lit* last) {
+        if(binary) {
+            buffer.push_back(kind);
+            for(const Lit* l = first; l != last; l++) {
+                uint32_t x = *l;
+                while(x > 127) {
+                    buffer.push_back(128 | (x & 127));
+                    x >>= 7;
+                }
+                buffer.push_back(x);
+            }
+            buffer.push_back(0);
+        }
+        else {
+            char text[16];
+            if(kind == 'd')
+                buffer.insert(buffer.end(), {'d', ' '});
+            for(const Lit* l = first; l != last; l++) {
+                int n = std::snprintf(text, sizeof text, "%d ", toLiteral(*l));
+                buffer.insert(buffer.end(), text, text + n);
+            }
+            buffer.insert(buffer.end(), {'0', '\n'});
+        }
+        if(buffer.size() >= BufferSize)
+            flush();
+    }
+
+    void add(const Lit* first, const Lit* last) { write('a', first, last); }
+    void remove(const Lit* first, const Lit* last) { write('d', first, last); }
+};
+
+// Kruzni bafer kroz koji jedna nit portfolija izvozi kratke naucene
+// klauze. Pise samo vlasnik, a ostale niti citaju bez zakljucavanja, svaka
+// od svoje pozicije. Klauza je zapisana kao rec (lbd << 16 | broj
+// literala) za kojom slede literali. Citalac koga je pisac prestigao za ceo
+// krug preskace klauze koje nije stigao da procita.
+struct ExportBuffer {
+    static const size_t Capacity = 1 << 16;
+    static const uint32_t MaxSize = 64;
+
+    std::unique_ptr<std::atomic<uint32_t>[]> words{new std::atomic<uint32_t>[Capacity]};
+    std::atomic<uint64_t> head{0};
+
+    void push(const Lit* lits, uint32_t size, uint32_t lbd) {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        // Kao kod seqlock-a: citalac koji vidi neku od narednih reci posle
+        // svoje acquire ograde vidi i head bar h, pa prepoznaje prepisivanje.
+        std::atomic_thread_fence(std::memory_order_release);
+        words[h % Capacity].store(lbd << 16 | size, std::memory_order_relaxed);
+        for(uint32_t i = 0; i < size; i++)
+            words[(h + 1 + i) % Capacity].store(lits[i], std::memory_order_relaxed);
+        head.store(h + 1 + size, std::memory_order_release);
+    }
+
+    // Poziva f(literali, lbd) za svaku klauzu dodatu posle pozicije cursor.
+    // Procitana klauza vazi samo ako je pisac posle citanja i dalje dovoljno
+    // daleko da nije mogao da je prepise.
+    template<typename F>
+    void read(uint64_t& cursor, std::vector<Lit>& lits, F f) const {
+        uint64_t h = head.load(std::memory_order_acquire);
+        if(h - cursor > Capacity - MaxSize - 1)
+            cursor = h;
+        while(cursor < h) {
+            uint32_t header = words[cursor % Capacity].load(std::memory_order_relaxed);
+            uint32_t size = header & 0xffff;
+            lits.resize(size);
+            for(uint32_t i = 0; i < size && size <= MaxSize; i++)
+                lits[i] = words[(cursor + 1 + i) % Capacity].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t now = head.load(std::memory_order_relaxed);
+            if(size > MaxSize || now + MaxSize + 1 > cursor + Capacity) {
+                cursor = now;
+                return;
+            }
+            f(lits, header >> 16);
+            cursor += 1 + size;
+        }
+    }
+};
+
+// Stanje koje dele niti portfolija: bafer za izvoz svake niti i zastavica
+// kojom nit koja prva nadje odgovor zaustavlja ostale.
+struct Sharing {
+    std::vector<ExportBuffer> buffers;
+    std::atomic<bool> stop{false};
+    uint32_t maxSize = 8;
+    uint32_t maxLbd = 4;
+
+    explicit Sharing(int workers) : buffers(workers) {}
+};
+
+enum Result { Unsat, Sat, Unknown };
+
 struct PartialValuation {
     int atomCount;
-    std::map<Atom, bool> value;
-    std::vector<Literal> stack;
+    ClauseArena clauses;
+    std::vector<ClauseRef> original;
+    std::vector<ClauseRef> learnts;
+    // Sve informacije o atomu se cuvaju u nizovima indeksiranim atomom:
+    // vrednost (-1 netacno, 0 nedodeljeno, 1 tacno), nivo odlucivanja,
+    // klauza iz koje je literal propagiran (NoClause za odluke) i pozicija
+    // na steku.
+    std::vector<signed char> value;
+    std::vector<int> level;
+    std::vector<ClauseRef> reason;
+    std::vector<int> trailPos;
+    std::vector<Lit> trail;
+    std::vector<size_t> trailLim;
+    std::vector<std::vector<ClauseRef>> watches;
+    size_t propagated = 0;
+    std::vector<char> seen;
+    std::vector<Lit> toClear;
+    std::unique_ptr<BranchingHeuristic> heuristic;
+    std::vector<bool> phase;
+    bool phaseSaving = true;
+    bool initialPhase = true;
+    std::vector<long long> levelStamp;
+    long long stamp = 0;
+    Statistics stats;
+    // Na svakih reportInterval konflikata ispisuje se red sa napretkom (0
+    // iskljucuje ispis).
+    long long reportInterval = 0;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    ClauseDatabase db;
+    Inprocessing inprocessing;
+    Gauss gauss;
+    // Broj konflikata posle koga se u hibridnom rezimu ponovo pokrece
+    // lokalna pretraga.
+    long long nextLocalSearch = 0;
+    ProofWriter* proof = nullptr;
+    // Nit u portfoliju: sa kojim nitima deli klauze, koja je po redu i do
+    // kog mesta je procitala bafere ostalih niti.
+    Sharing* sharing = nullptr;
+    int worker = 0;
+    std::vector<uint64_t> cursors;
+    std::vector<Lit> imported;
+    // Pretpostavke se dodeljuju kao odluke na nivoima 1..n, pre svih ostalih
+    // odluka. Nivo ciji je literal vec tacan ostaje prazan.
+    std::vector<Lit> assumptions;
+    // Izveden je konflikt na nivou 0, pa je formula nezadovoljiva bez
+    // obzira na pretpostavke.
+    bool inconsistent = false;
+    // Posle UNSAT odgovora pod pretpostavkama: pretpostavke iz kojih sledi
+    // konflikt.
+    std::vector<Lit> failed;
+
+    void print() {
+        size_t d = 0;
+        for(size_t i = 0; i < trail.size(); i++) {
+            while(d < trailLim.size() && trailLim[d] == i) {
+                std::cout << 0 << ' ';
+                d++;
+            }
+            std::cout << toLiteral(trail[i]) << ' ';
+        }
+        std::cout << std::endl;
+    }
+
+    // Jedan red sa trenutnim brojacima, ispisan odjednom da se redovi niti
+    // portfolija ne bi preplitali.
+    void report() const {
+        std::chrono::duration<double> time = std::chrono::steady_clock::now() - startTime;
+        std::string line = "c ";
+        if(sharing)
+            line += "worker " + std::to_string(worker) + " ";
+        line += "time " + std::to_string(time.count())
+            + " conflicts " + std::to_string(stats.conflicts)
+            + " decisions " + std::to_string(stats.decisions)
+            + " propagations " + std::to_string(stats.propagations)
+            + " restarts " + std::to_string(stats.restarts)
+            + " learnt " + std::to_string(learnts.size())
+            + " trail " + std::to_string(trail.size()) + "\n";
+        std::fwrite(line.data(), 1, line.size(), stdout);
+        std::fflush(stdout);
+    }
+
+    int decisionLevel() const {
+        return trailLim.size();
+    }
+
+    void push(Lit l, bool decide, ClauseRef from = NoClause) {
+        if(decide) {
+            trailLim.push_back(trail.size());
+            stats.decisions++;
+        }
+        Atom atom = atomOf(l);
+        value[atom] = l & 1 ? -1 : 1;
+        level[atom] = decisionLevel();
+        reason[atom] = from;
+        trailPos[atom] = trail.size();
+        trail.push_back(l);
+        if(gauss.matrixOf[atom] >= 0)
+            gauss.matrices[gauss.matrixOf[atom]].assign(gauss.columnOf[atom], value[atom] > 0);
+    }
+
+    // Ponistava sve dodele iznad nivoa lvl, stek se samo skracuje. Brisu se
+    // i XOR razlozi ponistenih literala.
+    void backtrackTo(int lvl) {
+        if(decisionLevel() <= lvl)
+            return;
+        for(size_t i = trailLim[lvl]; i < trail.size(); i++) {
+            Atom atom = atomOf(trail[i]);
+            if(phaseSaving)
+                phase[atom] = value[atom] > 0;
+            value[atom] = 0;
+            heuristic->unassigned(atom);
+            if(gauss.matrixOf[atom] >= 0)
+                gauss.matrices[gauss.matrixOf[atom]].unassign(gauss.columnOf[atom]);
+        }
+        trail.resize(trailLim[lvl]);
+        trailLim.resize(lvl);
+        propagated = trail.size();
+        while(!gauss.reasons.empty()) {
+            ClauseRef c = gauss.reasons.back();
+            Atom atom = atomOf(clauses(c, 0));
+            if(value[atom] != 0 && reason[atom] == c)
+                break;
+            clauses.remove(c);
+            gauss.reasons.pop_back();
+        }
+    }
+
+    // Vraca poslednju odluku (0 ako odluka nema) i ponistava njen nivo.
+    Lit backtrack() {
+        if(trailLim.empty())
+            return 0;
+
+        Lit last = trail[trailLim.back()];
+        backtrackTo(decisionLevel() - 1);
+        return last;
+    }
+
+    bool isTrue(Lit l) const {
+        return value[atomOf(l)] == (l & 1 ? -1 : 1);
+    }
+
+    bool isFalse(Lit l) const {
+        return value[atomOf(l)] == (l & 1 ? 1 : -1);
+    }
+
+    // Vrednost DIMACS literala u (delimicnoj) valuaciji.
+    bool isTrue(Literal l) const {
+        return isTrue(toLit(l));
+    }
+
+    // Svaka klauza duzine >= 2 prati svoja prva dva literala. Jedinicne
+    // klauze se odmah dodeljuju, a prazna klauza znaci da je formula UNSAT.
+    // Klauze u areni su u tom trenutku poredjane jedna za drugom.
+    bool init() {
+        value.assign(atomCount + 1, 0);
+        level.assign(atomCount + 1, 0);
+        reason.assign(atomCount + 1, NoClause);
+        trailPos.assign(atomCount + 1, 0);
+        seen.assign(atomCount + 1, 0);
+        phase.assign(atomCount + 1, initialPhase);
+        levelStamp.assign(atomCount + 1, 0);
+        heuristic->init(atomCount);
+        trail.reserve(atomCount);
+        watches.assign(2 * atomCount + 2, {});
+        gauss.matrixOf.assign(atomCount + 1, -1);
+        gauss.columnOf.assign(atomCount + 1, -1);
+
+        ClauseRef next;
+        for(ClauseRef c = 0; c < clauses.memory.size(); c = next) {
+            next = c + ClauseArena::HeaderSize + clauses.size(c);
+            Lit* first = clauses.begin(c);
+            Lit* last = clauses.end(c);
+            std::sort(first, last);
+            last = std::unique(first, last);
+            clauses.shrink(c, last - first);
+            bool tautology = false;
+            for(Lit* l = first; l + 1 < last; l++)
+                if((*l ^ 1) == l[1])
+                    tautology = true;
+            if(tautology) {
+                clauses.remove(c);
+                continue;
+            }
+
+            if(clauses.size(c) == 0)
+                return false;
+            if(clauses.size(c) == 1) {
+                if(isFalse(*first))
+                    return false;
+                if(!isTrue(*first))
+                    push(*first, false);
+                clauses.remove(c);
+                continue;
+            }
+            original.push_back(c);
+            attach(c);
+        }
+        return true;
+    }
+
+    // Dodaje atome do n. Dodeljene vrednosti, naucene klauze i stanje
+    // heuristike ostaju.
+    void grow(int n) {
+        if(n <= atomCount)
+            return;
+        value.resize(n + 1, 0);
+        level.resize(n + 1, 0);
+        reason.resize(n + 1, NoClause);
+        trailPos.resize(n + 1, 0);
+        seen.resize(n + 1, 0);
+        phase.resize(n + 1, initialPhase);
+        levelStamp.resize(n + 1, 0);
+        watches.resize(2 * n + 2);
+        gauss.matrixOf.resize(n + 1, -1);
+        gauss.columnOf.resize(n + 1, -1);
+        heuristic->grow(n);
+        atomCount = n;
+    }
+
+    // Dodaje originalnu klauzu posle init(), na nivou 0. Literali netacni na
+    // nivou 0 se izbacuju, a klauza koja je tamo vec tacna se preskace.
+    // Vraca false ako klauza postane prazna.
+    bool addClause(std::vector<Lit>& lits) {
+        backtrackTo(0);
+        std::sort(begin(lits), end(lits));
+        lits.erase(std::unique(begin(lits), end(lits)), end(lits));
+        size_t j = 0;
+        for(size_t i = 0; i < lits.size(); i++) {
+            if(isTrue(lits[i]) || (i + 1 < lits.size() && lits[i + 1] == (lits[i] ^ 1)))
+                return true;
+            if(!isFalse(lits[i]))
+                lits[j++] = lits[i];
+        }
+        lits.resize(j);
+        if(lits.empty()) {
+            inconsistent = true;
+            return false;
+        }
+        if(lits.size() == 1) {
+            push(lits[0], false);
+            return true;
+        }
+        ClauseRef c = clauses.add(lits.data(), lits.size());
+        original.push_back(c);
+        attach(c);
+        return true;
+    }
+
+    // Trazi XOR ogranicenja zapisana klauzama: k atoma i 2^(k-1) klauza nad
+    // njima sa svim rasporedima znakova iste parnosti. Klauza zabranjuje
+    // jednu dodelu (atom je tacan tacno kada je njegov literal negiran), pa
+    // zabranjene parne dodele znace da je XOR atoma 1, a neparne da je 0.
+    // Ocekuje klauze sortirane kao posle init().
+    void detectXors(size_t maxSize) {
+        std::vector<ClauseRef> candidates;
+        for(ClauseRef c : original)
+            if(clauses.size(c) >= 2 && clauses.size(c) <= maxSize)
+                candidates.push_back(c);
+        auto atomsLess = [&](ClauseRef a, ClauseRef b) {
+            if(clauses.size(a) != clauses.size(b))
+                return clauses.size(a) < clauses.size(b);
+            for(uint32_t i = 0; i < clauses.size(a); i++)
+                if(atomOf(clauses(a, i)) != atomOf(clauses(b, i)))
+                    return atomOf(clauses(a, i)) < atomOf(clauses(b, i));
+            return false;
+        };
+        std::sort(begin(candidates), end(candidates), atomsLess);
+
+        std::vector<char> forbidden;
+        for(size_t i = 0, j; i < candidates.size(); i = j) {
+            j = i + 1;
+            while(j < candidates.size() && !atomsLess(candidates[i], candidates[j]))
+                j++;
+            uint32_t size = clauses.size(candidates[i]);
+            if(j - i < (1u << (size - 1)))
+                continue;
+            forbidden.assign(1u << size, 0);
+            for(size_t k = i; k < j; k++) {
+                uint32_t mask = 0;
+                for(uint32_t l = 0; l < size; l++)
+                    mask |= (clauses(candidates[k], l) & 1) << l;
+                forbidden[mask] = 1;
+            }
+            for(int parity = 0; parity < 2; parity++) {
+                bool all = true;
+                for(uint32_t mask = 0; mask < forbidden.size() && all; mask++)
+                    if(__builtin_popcount(mask) % 2 == parity && !forbidden[mask])
+                        all = false;
+                if(!all)
+                    continue;
+                Xor x{{}, parity == 0, false};
+                for(uint32_t l = 0; l < size; l++)
+                    x.atoms.push_back(atomOf(clauses(candidates[i], l)));
+                gauss.xors.push_back(x);
+            }
+        }
+        gauss.dirty = true;
+    }
+
+    // Na nivou 0 gradi matrice iz svih XOR ogranicenja: atomi povezani
+    // zajednickim ogranicenjima idu u istu matricu, koja se odmah svodi, a
+    // redovi se zatim podese prema vec dodeljenim atomima. Vraca false ako
+    // je sistem protivrecan.
+    bool initGauss() {
+        backtrackTo(0);
+        gauss.dirty = false;
+        gauss.matrices.clear();
+        gauss.matrixOf.assign(atomCount + 1, -1);
+        gauss.columnOf.assign(atomCount + 1, -1);
+        stats.xorConstraints = 0;
+        stats.xorMatrices = 0;
+
+        std::vector<Atom> parent(atomCount + 1);
+        for(Atom atom = 0; atom <= atomCount; atom++)
+            parent[atom] = atom;
+        auto find = [&](Atom atom) {
+            while(parent[atom] != atom)
+                atom = parent[atom] = parent[parent[atom]];
+            return atom;
+        };
+        for(const Xor& x : gauss.xors) {
+            if(x.atoms.empty() && x.rhs) {
+                inconsistent = true;
+                return false;
+            }
+            for(Atom atom : x.atoms)
+                parent[find(atom)] = find(x.atoms[0]);
+        }
+        std::vector<int> componentOf(atomCount + 1, -1);
+        std::vector<std::vector<const Xor*>> components;
+        for(const Xor& x : gauss.xors) {
+            if(x.atoms.empty())
+                continue;
+            Atom root = find(x.atoms[0]);
+            if(componentOf[root] == -1) {
+                componentOf[root] = components.size();
+                components.emplace_back();
+            }
+            components[componentOf[root]].push_back(&x);
+        }
+
+        for(const std::vector<const Xor*>& component : components) {
+            XorMatrix m;
+            bool native = false;
+            for(const Xor* x : component) {
+                m.atoms.insert(end(m.atoms), begin(x->atoms), end(x->atoms));
+                native |= x->native;
+            }
+            std::sort(begin(m.atoms), end(m.atoms));
+            m.atoms.erase(std::unique(begin(m.atoms), end(m.atoms)), end(m.atoms));
+            if(!native && (component.size() > gauss.maxRows || m.atoms.size() > gauss.maxColumns))
+                continue;
+            m.words = (m.atoms.size() + 63) / 64;
+            m.bits.assign(component.size() * m.words, 0);
+            for(size_t r = 0; r < component.size(); r++) {
+                for(Atom atom : component[r]->atoms) {
+                    size_t col = std::lower_bound(begin(m.atoms), end(m.atoms), atom) - begin(m.atoms);
+                    m.bits[r * m.words + col / 64] |= uint64_t(1) << (col % 64);
+                }
+                m.rhs.push_back(component[r]->rhs);
+            }
+            if(!m.eliminate()) {
+                inconsistent = true;
+                return false;
+            }
+            m.watches.assign(m.atoms.size(), {});
+            m.assigned.assign(m.words, 0);
+            m.positive.assign(m.words, 0);
+            for(size_t col = 0; col < m.atoms.size(); col++) {
+                Atom atom = m.atoms[col];
+                gauss.matrixOf[atom] = gauss.matrices.size();
+                gauss.columnOf[atom] = col;
+                if(value[atom] != 0)
+                    m.assign(col, value[atom] > 0);
+            }
+            for(size_t r = 0; r < m.rows(); r++)
+                m.watches[m.basic[r]].push_back(r);
+            stats.xorConstraints += component.size();
+            stats.xorMatrices++;
+            gauss.matrices.push_back(std::move(m));
+        }
+
+        for(XorMatrix& m : gauss.matrices)
+            for(size_t r = 0; r < m.rows(); r++)
+                if(repairXor(m, r) != NoClause) {
+                    inconsistent = true;
+                    return false;
+                }
+        return true;
+    }
+
+    void attach(ClauseRef c) {
+        watches[clauses(c, 0)].push_back(c);
+        watches[clauses(c, 1)].push_back(c);
+    }
+
+    // Obradjuje literale sa steka koji jos nisu propagirani. Posecuju se samo
+    // klauze koje prate negaciju dodeljenog literala i XOR redovi koji prate
+    // njegov atom. Vraca klauzu u konfliktu ili NoClause ako konflikta nema.
+    ClauseRef propagate() {
+        PhaseTimer timer(stats.propagateTime);
+        while(propagated < trail.size()) {
+            Lit l = trail[propagated++];
+            Lit falseLit = l ^ 1;
+            stats.propagations++;
+
+            std::vector<ClauseRef>& ws = watches[falseLit];
+            size_t i = 0, j = 0;
+            while(i < ws.size()) {
+                ClauseRef c = ws[i++];
+                Lit* lits = clauses.begin(c);
+                if(lits[0] == falseLit)
+                    std::swap(lits[0], lits[1]);
+                if(isTrue(lits[0])) {
+                    ws[j++] = c;
+                    continue;
+                }
+
+                bool moved = false;
+                for(uint32_t k = 2, size = clauses.size(c); k < size; k++) {
+                    if(!isFalse(lits[k])) {
+                        std::swap(lits[1], lits[k]);
+                        watches[lits[1]].push_back(c);
+                        moved = true;
+                        break;
+                    }
+                }
+                if(moved)
+                    continue;
+
+                ws[j++] = c;
+                if(isFalse(lits[0])) {
+                    while(i < ws.size())
+                        ws[j++] = ws[i++];
+                    ws.resize(j);
+                    return c;
+                }
+                push(lits[0], false, c);
+            }
+            ws.resize(j);
+            if(gauss.matrixOf[atomOf(l)] >= 0) {
+                ClauseRef conflict = propagateXor(atomOf(l));
+                if(conflict != NoClause)
+                    return conflict;
+            }
+        }
+        return NoClause;
+    }
+
+    // Klauza iz reda r matrice m: prvi je literal first, a zatim negacije
+    // tekucih vrednosti ostalih dodeljenih kolona. Za konflikt (first = 0)
+    // na prvo mesto ide literal sa najviseg nivoa. Klauza nije pracena i
+    // brise se pri bektrekingu.
+    ClauseRef xorClause(const XorMatrix& m, int r, Lit first) {
+        std::vector<Lit>& lits = gauss.lits;
+        lits.clear();
+        if(first)
+            lits.push_back(first);
+        const uint64_t* row = &m.bits[r * m.words];
+        for(size_t w = 0; w < m.words; w++) {
+            for(uint64_t set = row[w] & m.assigned[w]; set; set &= set - 1) {
+                Atom atom = m.atoms[w * 64 + __builtin_ctzll(set)];
+                lits.push_back(value[atom] > 0 ? 2 * atom + 1 : 2 * atom);
+            }
+        }
+        if(!first)
+            for(size_t k = 1; k < lits.size(); k++)
+                if(level[atomOf(lits[k])] > level[atomOf(lits[0])])
+                    std::swap(lits[0], lits[k]);
+        ClauseRef c = clauses.add(lits.data(), lits.size());
+        gauss.reasons.push_back(c);
+        return c;
+    }
+
+    // Poslednja dodeljena kolona reda r razlicita od except, ili -1.
+    int latestColumn(const XorMatrix& m, int r, int except) const {
+        int latest = -1;
+        const uint64_t* row = &m.bits[r * m.words];
+        for(size_t w = 0; w < m.words; w++) {
+            for(uint64_t set = row[w] & m.assigned[w]; set; set &= set - 1) {
+                int col = w * 64 + __builtin_ctzll(set);
+                if(col != except && (latest == -1 || trailPos[m.atoms[col]] > trailPos[m.atoms[latest]]))
+                    latest = col;
+            }
+        }
+        return latest;
+    }
+
+    void watchXor(XorMatrix& m, int r, int col) {
+        if(m.watch[r] == col)
+            return;
+        m.watch[r] = col;
+        if(col != -1)
+            m.watches[col].push_back(r);
+    }
+
+    // Nova bazna kolona c reda r se izbacuje iz ostalih redova, koji zatim
+    // cekaju popravku pracenja.
+    void pivotXor(XorMatrix& m, int r, int c) {
+        for(size_t s = 0; s < m.rows(); s++) {
+            if((int)s != r && m.has(s, c)) {
+                m.addRow(s, r);
+                gauss.pending.push_back(s);
+            }
+        }
+        m.basic[r] = c;
+        m.watches[c].push_back(r);
+    }
+
+    // Vraca red r u ispravno stanje posle dodela: ako je bazna kolona
+    // dodeljena, pivotira na nedodeljenu kolonu, pa prati jos jednu
+    // nedodeljenu. Ako nedodeljena ostane samo bazna, propagira je; ako je
+    // ceo red dodeljen i nije zadovoljen, vraca klauzu u konfliktu. Konflikt
+    // bez literala sa tekuceg nivoa (red promenjen pivotiranjem) se
+    // prijavljuje posle bektrekinga na njegov najvisi nivo. Kada je quiet,
+    // samo se popravlja pracenje.
+    ClauseRef updateXor(XorMatrix& m, int r, bool quiet = false) {
+        if(m.isAssigned(m.basic[r])) {
+            int c = m.column(r, true, m.watch[r]);
+            if(c == -1)
+                c = m.column(r, true);
+            if(c != -1)
+                pivotXor(m, r, c);
+        }
+        int b = m.basic[r];
+        if(!m.isAssigned(b)) {
+            int w = m.watch[r];
+            if(w == -1 || w == b || m.isAssigned(w) || !m.has(r, w))
+                w = m.column(r, true, b);
+            if(w != -1) {
+                watchXor(m, r, w);
+                return NoClause;
+            }
+            watchXor(m, r, latestColumn(m, r, b));
+            if(quiet)
+                return NoClause;
+            Lit l = m.parity(r) ? 2 * m.atoms[b] : 2 * m.atoms[b] + 1;
+            push(l, false, xorClause(m, r, l));
+            stats.xorPropagations++;
+            return NoClause;
+        }
+        watchXor(m, r, latestColumn(m, r, b));
+        if(quiet || !m.parity(r))
+            return NoClause;
+        int top = level[m.atoms[latestColumn(m, r, -1)]];
+        if(top < decisionLevel())
+            backtrackTo(top);
+        if(top == 0)
+            inconsistent = true;
+        stats.xorConflicts++;
+        return xorClause(m, r, 0);
+    }
+
+    // Popravlja red r, pa redove koje je pri tome promenilo pivotiranje.
+    // Posle konflikta se ostalim redovima samo popravlja pracenje.
+    ClauseRef repairXor(XorMatrix& m, int r) {
+        ClauseRef conflict = updateXor(m, r);
+        while(!gauss.pending.empty()) {
+            int s = gauss.pending.back();
+            gauss.pending.pop_back();
+            ClauseRef c = updateXor(m, s, conflict != NoClause);
+            if(conflict == NoClause)
+                conflict = c;
+        }
+        return conflict;
+    }
+
+    // Obradjuje redove koji prate kolonu dodeljenog atoma. Vraca klauzu u
+    // konfliktu ili NoClause.
+    ClauseRef propagateXor(Atom atom) {
+        XorMatrix& m = gauss.matrices[gauss.matrixOf[atom]];
+        int col = gauss.columnOf[atom];
+        std::vector<int>& rows = gauss.rows;
+        rows.clear();
+        rows.swap(m.watches[col]);
+        m.stamp++;
+        ClauseRef conflict = NoClause;
+        size_t k = 0;
+        for(; k < rows.size() && conflict == NoClause; k++) {
+            int r = rows[k];
+            if(m.rowStamp[r] == m.stamp || (m.basic[r] != col && m.watch[r] != col))
+                continue;
+            m.rowStamp[r] = m.stamp;
+            conflict = repairXor(m, r);
+            if(m.basic[r] == col || m.watch[r] == col)
+                m.watches[col].push_back(r);
+        }
+        for(; k < rows.size(); k++)
+            m.watches[col].push_back(rows[k]);
+        return conflict;
+    }
+
+    unsigned abstractLevel(Atom atom) const {
+        return 1u << (level[atom] & 31);
+    }
+
+    // Literal p je suvisan u naucenoj klauzi ako se svi literali iz
+    // njegovog razloga (rekurzivno) vec nalaze u klauzi ili su na nivou 0.
+    bool redundant(Lit p, unsigned levels) {
+        std::vector<Lit> stack{p};
+        size_t top = toClear.size();
+        while(!stack.empty()) {
+            Atom atom = atomOf(stack.back());
+            stack.pop_back();
+            ClauseRef c = reason[atom];
+            for(const Lit* q = clauses.begin(c); q != clauses.end(c); q++) {
+                Atom v = atomOf(*q);
+                if(v == atom || seen[v] || level[v] == 0)
+                    continue;
+                if(reason[v] != NoClause && (abstractLevel(v) & levels)) {
+                    seen[v] = 1;
+                    stack.push_back(*q);
+                    toClear.push_back(*q);
+                }
+                else {
+                    for(size_t i = top; i < toClear.size(); i++)
+                        seen[atomOf(toClear[i])] = 0;
+                    toClear.resize(top);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Analiza konflikta po prvoj tacki dominacije (first UIP). Obilazi graf
+    // implikacija unazad po steku dok na tekucem nivou ne ostane samo jedan
+    // literal. U learnt[0] je literal koji ce nova klauza propagirati, a u
+    // learnt[1] literal sa najviseg preostalog nivoa. Vraca nivo na koji
+    // treba skociti.
+    int analyze(ClauseRef conflict, std::vector<Lit>& learnt) {
+        PhaseTimer timer(stats.analyzeTime);
+        learnt.assign(1, 0);
+        int pathCount = 0;
+        Lit p = 0;
+        size_t i = trail.size();
+        do {
+            if(clauses.has(conflict, ClauseArena::Learnt)) {
+                db.bump(clauses, learnts, conflict);
+                if(clauses.lbd(conflict) > db.coreLbd) {
+                    uint32_t newLbd = lbd(clauses.begin(conflict), clauses.end(conflict));
+                    if(newLbd < clauses.lbd(conflict))
+                        clauses.setLbd(conflict, newLbd);
+                }
+            }
+            for(const Lit* q = clauses.begin(conflict); q != clauses.end(conflict); q++) {
+                Atom v = atomOf(*q);
+                if(v == atomOf(p) || seen[v] || level[v] == 0)
+                    continue;
+                seen[v] = 1;
+                heuristic->bump(v);
+                if(level[v] >= decisionLevel())
+                    pathCount++;
+                else
+                    learnt.push_back(*q);
+            }
+            while(!seen[atomOf(trail[--i])]);
+            p = trail[i];
+            conflict = reason[atomOf(p)];
+            seen[atomOf(p)] = 0;
+            pathCount--;
+        } while(pathCount > 0);
+        learnt[0] = p ^ 1;
+
+        toClear.assign(begin(learnt) + 1, end(learnt));
+        unsigned levels = 0;
+        for(size_t k = 1; k < learnt.size(); k++)
+            levels |= abstractLevel(atomOf(learnt[k]));
+        size_t j = 1;
+        for(size_t k = 1; k < learnt.size(); k++)
+            if(reason[atomOf(learnt[k])] == NoClause || !redundant(learnt[k], levels))
+                learnt[j++] = learnt[k];
+        learnt.resize(j);
+        for(Lit q : toClear)
+            seen[atomOf(q)] = 0;
+
+        if(learnt.size() == 1)
+            return 0;
+        size_t max = 1;
+        for(size_t k = 2; k < learnt.size(); k++)
+            if(level[atomOf(learnt[k])] > level[atomOf(learnt[max])])
+                max = k;
+        std::swap(learnt[1], learnt[max]);
+        return level[atomOf(learnt[1])];
+    }
+
+    // Broj razlicitih nivoa odlucivanja medju literalima klauze (LBD).
+    uint32_t lbd(const Lit* first, const Lit* last) {
+        stamp++;
+        uint32_t count = 0;
+        for(const Lit* l = first; l != last; l++) {
+            int lvl = level[atomOf(*l)];
+            if(levelStamp[lvl] != stamp) {
+                levelStamp[lvl] = stamp;
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // Dodaje naucenu klauzu u bazu i dodeljuje njen prvi literal.
+    void learn(const std::vector<Lit>& learnt, uint32_t clauseLbd) {
+        stats.learnt++;
+        if(proof)
+            proof->add(learnt.data(), learnt.data() + learnt.size());
+        if(sharing && learnt.size() <= sharing->maxSize && clauseLbd <= sharing->maxLbd) {
+            sharing->buffers[worker].push(learnt.data(), learnt.size(), clauseLbd);
+            stats.exported++;
+        }
+        if(learnt.size() == 1) {
+            push(learnt[0], false);
+            return;
+        }
+        ClauseRef c = clauses.add(learnt.data(), learnt.size(), true, clauseLbd);
+        learnts.push_back(c);
+        attach(c);
+        push(learnt[0], false, c);
+    }
+
+    // Preuzima klauze koje su ostale niti izvezle od poslednjeg poziva.
+    // Klauze se dodaju na nivou 0, bez literala koji su tamo netacni, pa su
+    // preostali literali nedodeljeni i mogu se odmah pratiti. Vraca false
+    // ako je izvedena prazna klauza.
+    bool importClauses() {
+        bool ok = true;
+        for(size_t w = 0; w < sharing->buffers.size() && ok; w++) {
+            if(w == (size_t)worker)
+                continue;
+            sharing->buffers[w].read(cursors[w], imported, [&](std::vector<Lit>& lits, uint32_t clauseLbd) {
+                if(!ok)
+                    return;
+                backtrackTo(0);
+                size_t j = 0;
+                for(Lit l : lits) {
+                    if(isTrue(l))
+                        return;
+                    if(!isFalse(l))
+                        lits[j++] = l;
+                }
+                lits.resize(j);
+                stats.imported++;
+                if(lits.empty()) {
+                    ok = false;
+                    inconsistent = true;
+                }
+                else if(lits.size() == 1)
+                    push(lits[0], false);
+                else {
+                    ClauseRef c = clauses.add(lits.data(), lits.size(), true, clauseLbd);
+                    learnts.push_back(c);
+                    attach(c);
+                }
+            });
+        }
+        return ok;
+    }
+
+    bool locked(ClauseRef c) const {
+        Lit first = *clauses.begin(c);
+        return reason[atomOf(first)] == c && isTrue(first);
+    }
+
+    // Brise polovinu manje vrednih naucenih klauza. Obrisane klauze se
+    // izbacuju iz listi pracenja, a arena se sabija kada obrisane klauze
+    // zauzmu vise od petine memorije.
+    void reduceDb() {
+        PhaseTimer timer(stats.reduceTime);
+        stats.reductions++;
+        db.nextReduce = stats.conflicts + db.reduceFirst + db.reduceIncrement * stats.reductions;
+
+        std::vector<ClauseRef> candidates;
+        for(ClauseRef c : learnts) {
+            if(clauses.lbd(c) <= db.coreLbd || locked(c))
+                continue;
+            if(clauses.lbd(c) <= db.tier2Lbd && clauses.has(c, ClauseArena::Used))
+                continue;
+            candidates.push_back(c);
+        }
+        std::sort(begin(candidates), end(candidates), [&](ClauseRef a, ClauseRef b) {
+            if(clauses.activity(a) != clauses.activity(b))
+                return clauses.activity(a) < clauses.activity(b);
+            return clauses.lbd(a) > clauses.lbd(b);
+        });
+        for(size_t k = 0; k < candidates.size() / 2; k++) {
+            if(proof)
+                proof->remove(clauses.begin(candidates[k]), clauses.end(candidates[k]));
+            clauses.remove(candidates[k]);
+            stats.deleted++;
+        }
+
+        size_t j = 0;
+        for(ClauseRef c : learnts) {
+            if(clauses.has(c, ClauseArena::Deleted))
+                continue;
+            clauses.clear(c, ClauseArena::Used);
+            learnts[j++] = c;
+        }
+        learnts.resize(j);
+        detachDeleted();
+
+        if(clauses.wasted > clauses.memory.size() / 5)
+            collectGarbage();
+    }
+
+    // Prepisuje sve zive klauze u novu arenu (originalne, pa naucene) i
+    // prevezuje reference u listama pracenja, razlozima i XOR razlozima.
+    void collectGarbage() {
+        ClauseArena to;
+        to.memory.reserve(clauses.memory.size() - clauses.wasted);
+        for(ClauseRef& c : original)
+            c = clauses.relocate(c, to);
+        for(ClauseRef& c : learnts)
+            c = clauses.relocate(c, to);
+        for(std::vector<ClauseRef>& ws : watches)
+            for(ClauseRef& c : ws)
+                c = clauses.relocate(c, to);
+        for(Lit l : trail) {
+            ClauseRef& c = reason[atomOf(l)];
+            if(c != NoClause)
+                c = clauses.has(c, ClauseArena::Deleted) ? NoClause : clauses.relocate(c, to);
+        }
+        for(ClauseRef& c : gauss.reasons)
+            c = clauses.relocate(c, to);
+        clauses = std::move(to);
+    }
+
+    // Izbacuje obrisane klauze iz listi pracenja i iz nizova originalnih i
+    // naucenih klauza.
+    void detachDeleted() {
+        auto live = [&](std::vector<ClauseRef>& refs) {
+            size_t k = 0;
+            for(ClauseRef c : refs)
+                if(!clauses.has(c, ClauseArena::Deleted))
+                    refs[k++] = c;
+            refs.resize(k);
+        };
+        live(original);
+        live(learnts);
+        for(std::vector<ClauseRef>& ws : watches)
+            live(ws);
+    }
+
+    // Na nivou 0 zamenjuje klauzu c klauzom lits, ciji literali nisu
+    // dodeljeni. U dokaz se upisuje nova klauza, pa brisanje stare. Vraca
+    // novu klauzu, odnosno NoClause ako je lits jedinicna (literal se tada
+    // dodeljuje) ili prazna.
+    ClauseRef replace(ClauseRef c, const std::vector<Lit>& lits) {
+        if(proof) {
+            proof->add(lits.data(), lits.data() + lits.size());
+            proof->remove(clauses.begin(c), clauses.end(c));
+        }
+        bool learnt = clauses.has(c, ClauseArena::Learnt);
+        uint32_t clauseLbd = std::min<uint32_t>(clauses.lbd(c), lits.size());
+        clauses.remove(c);
+        if(lits.empty() || (lits.size() == 1 && isFalse(lits[0]))) {
+            inconsistent = true;
+            return NoClause;
+        }
+        if(lits.size() == 1) {
+            if(!isTrue(lits[0]))
+                push(lits[0], false);
+            return NoClause;
+        }
+        ClauseRef d = clauses.add(lits.data(), lits.size(), learnt, clauseLbd);
+        attach(d);
+        return d;
+    }
+
+    // Probanje korena grafa binarnih implikacija: literal koji se ne javlja
+    // ni u jednoj binarnoj klauzi, a njegova negacija se javlja, nista ne
+    // implicira, a sam pokrece lanac implikacija. Ako propagacija korena l
+    // dovodi do konflikta, ~l vazi na nivou 0.
+    void probe(long long budget) {
+        std::vector<int> binary(2 * atomCount + 2, 0);
+        for(const std::vector<ClauseRef>* refs : {&original, &learnts})
+            for(ClauseRef c : *refs)
+                if(clauses.size(c) == 2) {
+                    binary[clauses(c, 0)]++;
+                    binary[clauses(c, 1)]++;
+                }
+        std::vector<Lit> roots;
+        for(Lit l = 2; l < 2 * (Lit)atomCount + 2; l++)
+            if(value[atomOf(l)] == 0 && binary[l] == 0 && binary[l ^ 1] > 0)
+                roots.push_back(l);
+
+        long long limit = stats.propagations + budget;
+        size_t k = 0;
+        for(; k < roots.size() && stats.propagations < limit && !inconsistent; k++) {
+            Lit l = roots[(inprocessing.probeCursor + k) % roots.size()];
+            if(value[atomOf(l)] != 0)
+                continue;
+            push(l, true);
+            bool failedLiteral = propagate() != NoClause;
+            backtrackTo(0);
+            if(!failedLiteral)
+                continue;
+            stats.failedLiterals++;
+            Lit unit = l ^ 1;
+            if(proof)
+                proof->add(&unit, &unit + 1);
+            push(unit, false);
+            if(propagate() != NoClause)
+                inconsistent = true;
+        }
+        inprocessing.probeCursor += k;
+    }
+
+    // Vivifikacija klauze l1 | ... | lk: redom se pretpostavljaju ~l1,
+    // ~l2, ... Literali koje propagacija ucini netacnim se izbacuju, a kada
+    // propagacija dovede do konflikta ili ucini neki li tacnim, klauza se
+    // skracuje na do tada pretpostavljene literale (i li). Literali se
+    // citaju iz kopije, jer propagacija premesta literale u samoj klauzi.
+    // Vraca klauzu koja zamenjuje c (NoClause ako je c obrisana).
+    ClauseRef vivify(ClauseRef c, std::vector<Lit>& lits, std::vector<Lit>& copy) {
+        copy.assign(clauses.begin(c), clauses.end(c));
+        lits.clear();
+        bool satisfied = false;
+        for(Lit l : copy) {
+            if(isTrue(l)) {
+                if(level[atomOf(l)] == 0)
+                    satisfied = true;
+                else
+                    lits.push_back(l);
+                break;
+            }
+            if(isFalse(l))
+                continue;
+            lits.push_back(l);
+            push(l ^ 1, true);
+            if(propagate() != NoClause)
+                break;
+        }
+        backtrackTo(0);
+        if(satisfied) {
+            if(proof)
+                proof->remove(clauses.begin(c), clauses.end(c));
+            clauses.remove(c);
+            return NoClause;
+        }
+        if(lits.size() == clauses.size(c))
+            return c;
+        stats.vivifiedClauses++;
+        stats.vivifiedLiterals += clauses.size(c) - lits.size();
+        c = replace(c, lits);
+        // Nova jedinicna klauza se propagira odmah, pre sledece odluke.
+        if(!inconsistent && propagate() != NoClause)
+            inconsistent = true;
+        return c;
+    }
+
+    // Vivifikuje jos nevivifikovane naucene klauze iz drugog nivoa (polovina
+    // budzeta), pa redom originalne klauze.
+    void vivify(long long budget) {
+        std::vector<Lit> lits, copy;
+        long long limit = stats.propagations + budget / 2;
+        for(size_t i = 0; i < learnts.size() && stats.propagations < limit && !inconsistent; i++) {
+            ClauseRef c = learnts[i];
+            if(clauses.has(c, ClauseArena::Deleted) || clauses.has(c, ClauseArena::Vivified) || clauses.lbd(c) > db.tier2Lbd)
+                continue;
+            c = vivify(c, lits, copy);
+            if(c != NoClause) {
+                clauses.set(c, ClauseArena::Vivified);
+                learnts[i] = c;
+            }
+        }
+        limit += budget - budget / 2;
+        size_t k = 0;
+        for(; k < original.size() && stats.propagations < limit && !inconsistent; k++) {
+            size_t i = (inprocessing.vivifyCursor + k) % original.size();
+            if(!clauses.has(original[i], ClauseArena::Deleted)) {
+                ClauseRef c = vivify(original[i], lits, copy);
+                if(c != NoClause)
+                    original[i] = c;
+            }
+        }
+        inprocessing.vivifyCursor += k;
+    }
+
+    // Zamena ekvivalentnih literala: jako povezana komponenta grafa binarnih
+    // implikacija je skup ekvivalentnih literala. Svaki literal komponente
+    // se zamenjuje literalom sa najmanjim atomom, pa ostali atomi nestaju iz
+    // formule, a vrednosti im se u modelu vracaju u fillSubstituted().
+    // Komponente se traze Tarjanovim algoritmom, bez rekurzije.
+    void substitute() {
+        Lit n = 2 * atomCount + 2;
+        std::vector<std::vector<Lit>> implies(n);
+        for(const std::vector<ClauseRef>* refs : {&original, &learnts}) {
+            for(ClauseRef c : *refs) {
+                Lit a = clauses(c, 0), b = clauses(c, 1);
+                if(clauses.size(c) != 2 || value[atomOf(a)] != 0 || value[atomOf(b)] != 0)
+                    continue;
+                implies[a ^ 1].push_back(b);
+                implies[b ^ 1].push_back(a);
+            }
+        }
+
+        std::vector<int> index(n, -1), low(n, 0), componentOf(n, -1);
+        std::vector<char> onStack(n, 0);
+        std::vector<Lit> repr(n), stack, component;
+        std::vector<std::pair<Lit, size_t>> dfs;
+        for(Lit l = 0; l < n; l++)
+            repr[l] = l;
+        int counter = 0;
+        Lit contradiction = 0;
+        for(Lit root = 2; root < n && contradiction == 0; root++) {
+            if(index[root] != -1 || value[atomOf(root)] != 0 || implies[root].empty())
+                continue;
+            auto visit = [&](Lit l) {
+                index[l] = low[l] = counter++;
+                stack.push_back(l);
+                onStack[l] = 1;
+                dfs.push_back({l, 0});
+            };
+            visit(root);
+            while(!dfs.empty()) {
+                Lit v = dfs.back().first;
+                if(dfs.back().second < implies[v].size()) {
+                    Lit w = implies[v][dfs.back().second++];
+                    if(index[w] == -1)
+                        visit(w);
+                    else if(onStack[w])
+                        low[v] = std::min(low[v], index[w]);
+                    continue;
+                }
+                dfs.pop_back();
+                if(!dfs.empty())
+                    low[dfs.back().first] = std::min(low[dfs.back().first], low[v]);
+                if(low[v] != index[v])
+                    continue;
+                component.clear();
+                Lit w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    onStack[w] = 0;
+                    component.push_back(w);
+                } while(w != v);
+                Lit r = *std::min_element(begin(component), end(component));
+                for(Lit m : component)
+                    componentOf[m] = index[v];
+                for(Lit m : component) {
+                    if(componentOf[m ^ 1] == index[v])
+                        contradiction = m;
+                    repr[m] = r;
+                }
+            }
+        }
+
+        // Iz m -> ... -> ~m i ~m -> ... -> m sledi prazna klauza.
+        if(contradiction != 0) {
+            Lit unit = contradiction ^ 1;
+            if(proof)
+                proof->add(&unit, &unit + 1);
+            if(isFalse(unit))
+                inconsistent = true;
+            else if(!isTrue(unit))
+                push(unit, false);
+            return;
+        }
+
+        std::vector<Lit> equivalences;
+        for(Atom atom = 1; atom <= atomCount; atom++) {
+            Lit p = 2 * atom;
+            if(repr[p] == p)
+                continue;
+            stats.substitutedAtoms++;
+            inprocessing.substituted.push_back(p);
+            inprocessing.substituted.push_back(repr[p]);
+            equivalences.insert(end(equivalences), {p ^ 1, repr[p], p, repr[p] ^ 1});
+        }
+        if(equivalences.empty())
+            return;
+        if(proof)
+            for(size_t i = 0; i < equivalences.size(); i += 2)
+                proof->add(&equivalences[i], &equivalences[i] + 2);
 
-    void print() {
-        for(auto x : stack)
-            std::cout << x << ' ';
-        std::cout << std::endl;
+        std::vector<Lit> lits;
+        for(std::vector<ClauseRef>* refs : {&original, &learnts}) {
+            for(ClauseRef& c : *refs) {
+                if(inconsistent || clauses.has(c, ClauseArena::Deleted))
+                    continue;
+                bool changed = false;
+                for(const Lit* l = clauses.begin(c); l != clauses.end(c); l++)
+                    changed |= repr[*l] != *l;
+                if(!changed)
+                    continue;
+                lits.clear();
+                bool satisfied = false;
+                for(const Lit* l = clauses.begin(c); l != clauses.end(c); l++) {
+                    Lit m = repr[*l];
+                    satisfied |= isTrue(m);
+                    if(!isFalse(m))
+                        lits.push_back(m);
+                }
+                std::sort(begin(lits), end(lits));
+                lits.erase(std::unique(begin(lits), end(lits)), end(lits));
+                for(size_t i = 0; i + 1 < lits.size(); i++)
+                    satisfied |= (lits[i] ^ 1) == lits[i + 1];
+                if(satisfied) {
+                    if(proof)
+                        proof->remove(clauses.begin(c), clauses.end(c));
+                    clauses.remove(c);
+                    continue;
+                }
+                ClauseRef d = replace(c, lits);
+                if(d != NoClause)
+                    c = d;
+            }
+        }
+        if(proof)
+            for(size_t i = 0; i < equivalences.size(); i += 2)
+                proof->remove(&equivalences[i], &equivalences[i] + 2);
     }
 
-    void push(Literal l, bool decide) {
-        if(decide)
-            stack.push_back(0);
-        stack.push_back(l);
-        value[std::abs(l)] = l > 0;
+    // Vrednosti zamenjenih atoma u modelu, obrnutim redosledom zamena.
+    void fillSubstituted() {
+        const std::vector<Lit>& substituted = inprocessing.substituted;
+        for(size_t i = substituted.size(); i > 0; i -= 2)
+            value[atomOf(substituted[i - 2])] = isTrue(substituted[i - 1]) ? 1 : -1;
     }
 
-    Literal backtrack() {
-        Literal last = 0;
-        while(!stack.empty() && stack.back() != 0) {
-            last = stack.back();
-            stack.pop_back();
-            value.erase(std::abs(last));
+    // Inprocesiranje izmedju restarta, na nivou 0: probanje, vivifikacija i
+    // zamena ekvivalentnih literala. Sacuvane faze se pri tome ne menjaju.
+    // Vraca false ako je izvedena prazna klauza.
+    bool inprocess() {
+        backtrackTo(0);
+        stats.inprocessings++;
+        long long budget = inprocessing.effort * (stats.propagations - inprocessing.propagations);
+        bool saving = phaseSaving;
+        phaseSaving = false;
+        auto timed = [&](double& total, auto technique) {
+            auto start = std::chrono::steady_clock::now();
+            if(!inconsistent) {
+                technique();
+                if(!inconsistent && propagate() != NoClause)
+                    inconsistent = true;
+                detachDeleted();
+            }
+            std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+            total += time.count();
+        };
+        timed(stats.probeTime, [&]() { probe(budget); });
+        timed(stats.vivifyTime, [&]() { vivify(budget); });
+        if(inprocessing.substitute)
+            timed(stats.substituteTime, [&]() { substitute(); });
+        phaseSaving = saving;
+        if(clauses.wasted > clauses.memory.size() / 5)
+            collectGarbage();
+        inprocessing.next = stats.conflicts + inprocessing.interval * (stats.inprocessings + 1);
+        inprocessing.propagations = stats.propagations;
+        return !inconsistent;
+    }
+
+    // Restart sa ponovnim koriscenjem steka: zadrzavaju se nivoi cije bi
+    // odluke heuristika ionako ponovo izabrala pre sledeceg slobodnog atoma.
+    void restart(bool reuseTrail) {
+        stats.restarts++;
+        int lvl = 0;
+        if(reuseTrail) {
+            Atom next = heuristic->pick(value);
+            if(next == 0)
+                return;
+            heuristic->unassigned(next);
+            lvl = std::min<int>(assumptions.size(), decisionLevel());
+            while(lvl < decisionLevel() && heuristic->prefers(atomOf(trail[trailLim[lvl]]), next))
+                lvl++;
         }
+        backtrackTo(lvl);
+    }
+
+    // Pretpostavke iz kojih sledi da je pretpostavka a netacna (kao
+    // analyzeFinal u MiniSat-u). Graf implikacija se obilazi unazad od a;
+    // odluke na nivoima pretpostavki su same pretpostavke. Literal koji je
+    // DPLL postavio posle bektrekinga nema razlog, pa se za njega uzimaju
+    // sve pretpostavke ispod njegovog nivoa.
+    void analyzeFinal(Lit a) {
+        failed.assign(1, a);
+        if(level[atomOf(a)] == 0)
+            return;
+        seen[atomOf(a)] = 1;
+        for(size_t i = trail.size(); i-- > trailLim[0];) {
+            Atom atom = atomOf(trail[i]);
+            if(!seen[atom])
+                continue;
+            seen[atom] = 0;
+            if(reason[atom] != NoClause) {
+                for(const Lit* q = clauses.begin(reason[atom]); q != clauses.end(reason[atom]); q++)
+                    if(atomOf(*q) != atom && level[atomOf(*q)] > 0)
+                        seen[atomOf(*q)] = 1;
+            }
+            else if(trailLim[level[atom] - 1] == i && trail[i] == assumptions[level[atom] - 1])
+                failed.push_back(trail[i]);
+            else
+                failed.insert(failed.end(), begin(assumptions), begin(assumptions) + level[atom]);
+        }
+        std::sort(begin(failed), end(failed));
+        failed.erase(std::unique(begin(failed), end(failed)), end(failed));
+    }
+
+    // Otvara nivo za sledecu pretpostavku. Vraca false ako je ona netacna.
+    bool assume() {
+        Lit a = assumptions[decisionLevel()];
+        if(isFalse(a)) {
+            analyzeFinal(a);
+            return false;
+        }
+        if(isTrue(a))
+            trailLim.push_back(trail.size());
+        else
+            push(a, true);
+        // Zbog praznih nivoa broj nivoa moze da predje broj atoma.
+        if(levelStamp.size() < atomCount + assumptions.size() + 1)
+            levelStamp.resize(atomCount + assumptions.size() + 1, 0);
+        return true;
+    }
 
-        if(stack.empty())
+    // Vraca literal za sledecu odluku ili 0 ako su svi atomi dodeljeni.
+    Lit nextLiteral() {
+        Atom atom = heuristic->pick(value);
+        if(atom == 0)
             return 0;
+        return phase[atom] ? 2 * atom : 2 * atom + 1;
+    }
+};
 
-        stack.pop_back();
-        return last;
+// Preprocesiranje u stilu SatELite-a pre pretrage: propagacija jedinicnih
+// klauza, uklanjanje obuhvacenih klauza (subsumption), skracivanje klauza
+// samo-obuhvatajucom rezolucijom i ogranicena eliminacija atoma (BVE).
+// Klauze ostaju u areni, a id klauze je njen indeks u nizu clauses.
+struct Preprocessor {
+    enum Subsumption { None, Subsumed, Strengthened };
+
+    int atomCount;
+    ClauseArena arena;
+    std::vector<ClauseRef> clauses;
+    std::vector<uint64_t> signature;
+    std::vector<std::vector<int>> occurs;
+    std::vector<signed char> value;
+    std::vector<bool> eliminated;
+    std::vector<Lit> units;
+    std::vector<int> queue;
+    std::vector<char> queued;
+    std::vector<uint32_t> mark;
+    uint32_t markStamp = 0;
+    // Klauze eliminisanih atoma za rekonstrukciju modela: literali klauze
+    // (prvi je literal eliminisanog atoma), pa broj literala.
+    std::vector<Lit> eliminationStack;
+    ProofWriter* proof = nullptr;
+    std::vector<Lit> old;
+
+    size_t occurrenceLimit = 16;
+    size_t resolventLimit = 20;
+    size_t subsumptionLimit = 1000;
+
+    int clausesBefore = 0;
+    int clausesAfter = 0;
+    int atomsEliminated = 0;
+
+    Preprocessor(ClauseArena formula, int atomCount) : atomCount(atomCount), arena(std::move(formula)) {}
+
+    bool isTrue(Lit l) const { return value[atomOf(l)] == (l & 1 ? -1 : 1); }
+    bool isFalse(Lit l) const { return value[atomOf(l)] == (l & 1 ? 1 : -1); }
+    bool removed(int id) const { return arena.has(clauses[id], ClauseArena::Deleted); }
+
+    uint64_t computeSignature(ClauseRef c) const {
+        uint64_t sig = 0;
+        for(const Lit* l = arena.begin(c); l != arena.end(c); l++)
+            sig |= 1ull << (atomOf(*l) & 63);
+        return sig;
     }
 
-    bool isConflict(const Clause& clause) {
-        for(Literal l : clause) {
-            Atom atom = std::abs(l);
-            if(value.find(atom) == end(value))
+    void enqueue(int id) {
+        if(!queued[id]) {
+            queued[id] = 1;
+            queue.push_back(id);
+        }
+    }
+
+    // Dodaje klauzu (bez ponovljenih literala i tautologija). Jedinicne
+    // klauze se odmah stavljaju u red za propagaciju.
+    bool addClause(const Lit* lits, uint32_t size) {
+        if(size == 0)
+            return false;
+        if(size == 1) {
+            units.push_back(lits[0]);
+            return true;
+        }
+        int id = clauses.size();
+        ClauseRef c = arena.add(lits, size);
+        clauses.push_back(c);
+        signature.push_back(computeSignature(c));
+        queued.push_back(0);
+        for(uint32_t i = 0; i < size; i++)
+            occurs[lits[i]].push_back(id);
+        enqueue(id);
+        return true;
+    }
+
+    void detach(int id, Lit l) {
+        std::vector<int>& os = occurs[l];
+        auto it = std::find(begin(os), end(os), id);
+        *it = os.back();
+        os.pop_back();
+    }
+
+    // Brisanje se upisuje u dokaz osim kada je klauza postala jedinicna,
+    // jer njen literal ostaje u dokazu kao jedinicna klauza.
+    void removeClause(int id, bool log = true) {
+        ClauseRef c = clauses[id];
+        if(proof && log)
+            proof->remove(arena.begin(c), arena.end(c));
+        for(const Lit* l = arena.begin(c); l != arena.end(c); l++)
+            detach(id, *l);
+        arena.remove(c);
+    }
+
+    // Brise literal l iz klauze; klauza koja postane jedinicna prelazi u red
+    // za propagaciju. U dokaz se dodaje skracena klauza pa brise stara.
+    void removeLiteral(int id, Lit l) {
+        ClauseRef c = clauses[id];
+        if(proof)
+            old.assign(arena.begin(c), arena.end(c));
+        Lit* last = std::remove(arena.begin(c), arena.end(c), l);
+        arena.shrink(c, last - arena.begin(c));
+        if(proof) {
+            proof->add(arena.begin(c), arena.end(c));
+            proof->remove(old.data(), old.data() + old.size());
+        }
+        detach(id, l);
+        signature[id] = computeSignature(c);
+        if(arena.size(c) == 1) {
+            units.push_back(*arena.begin(c));
+            removeClause(id, false);
+        }
+        else
+            enqueue(id);
+    }
+
+    bool propagateUnits() {
+        while(!units.empty()) {
+            Lit l = units.back();
+            units.pop_back();
+            if(isFalse(l))
                 return false;
-            if(value[atom] == (l > 0))
+            if(isTrue(l))
+                continue;
+            value[atomOf(l)] = l & 1 ? -1 : 1;
+            std::vector<int> satisfied = occurs[l];
+            for(int id : satisfied)
+                removeClause(id);
+            std::vector<int> falsified = occurs[l ^ 1];
+            for(int id : falsified)
+                removeLiteral(id, l ^ 1);
+        }
+        return true;
+    }
+
+    // Da li klauza c obuhvata klauzu d, ili je obuhvata do na jedan
+    // suprotan literal flip (tada se iz d moze obrisati flip ^ 1).
+    Subsumption subsumes(ClauseRef c, ClauseRef d, Lit& flip) {
+        markStamp++;
+        for(const Lit* l = arena.begin(d); l != arena.end(d); l++)
+            mark[*l] = markStamp;
+        Subsumption result = Subsumed;
+        for(const Lit* l = arena.begin(c); l != arena.end(c); l++) {
+            if(mark[*l] == markStamp)
+                continue;
+            if(result == Subsumed && mark[*l ^ 1] == markStamp) {
+                result = Strengthened;
+                flip = *l;
+            }
+            else
+                return None;
+        }
+        return result;
+    }
+
+    // Unazad: trazi klauze koje klauza id obuhvata ili skracuje, preko liste
+    // pojavljivanja njenog najredjeg atoma.
+    bool backwardSubsume() {
+        while(!queue.empty()) {
+            int id = queue.back();
+            queue.pop_back();
+            queued[id] = 0;
+            if(removed(id))
+                continue;
+            ClauseRef c = clauses[id];
+            Lit best = *arena.begin(c);
+            for(const Lit* l = arena.begin(c); l != arena.end(c); l++)
+                if(occurs[*l].size() + occurs[*l ^ 1].size() < occurs[best].size() + occurs[best ^ 1].size())
+                    best = *l;
+            for(Lit q : {best, best ^ 1}) {
+                if(occurs[q].size() > subsumptionLimit)
+                    continue;
+                std::vector<int> candidates = occurs[q];
+                for(int other : candidates) {
+                    if(other == id || removed(other) || removed(id))
+                        continue;
+                    ClauseRef d = clauses[other];
+                    if(arena.size(d) < arena.size(c) || (signature[id] & ~signature[other]))
+                        continue;
+                    Lit flip;
+                    Subsumption s = subsumes(c, d, flip);
+                    if(s == Subsumed)
+                        removeClause(other);
+                    else if(s == Strengthened)
+                        removeLiteral(other, flip ^ 1);
+                }
+            }
+            if(!propagateUnits())
                 return false;
         }
         return true;
     }
 
-    bool hasConflict(const NormalForm& cnf) {
-        for(const Clause& c : cnf)
-            if(isConflict(c))
-                return true;
-        return false;
+    // Rezolventa klauza p i n po atomu; vraca false za tautologiju.
+    bool resolve(ClauseRef p, ClauseRef n, Atom atom, std::vector<Lit>& out) {
+        out.clear();
+        markStamp++;
+        for(const Lit* l = arena.begin(p); l != arena.end(p); l++) {
+            if(atomOf(*l) == atom)
+                continue;
+            mark[*l] = markStamp;
+            out.push_back(*l);
+        }
+        for(const Lit* l = arena.begin(n); l != arena.end(n); l++) {
+            if(atomOf(*l) == atom || mark[*l] == markStamp)
+                continue;
+            if(mark[*l ^ 1] == markStamp)
+                return false;
+            out.push_back(*l);
+        }
+        return true;
     }
 
-    Literal isUnitClause(const Clause& clause) {
-        Literal unit = 0;
-        for(Literal l : clause) {
-            Atom atom = std::abs(l);
-            if(value.find(atom) == end(value)) {
-                if(unit != 0)
-                    return 0;
-                unit = l;
+    // Atom se eliminise ako rezolvente svih parova klauza u kojima se
+    // pojavljuje pozitivno i negativno nema vise od samih tih klauza.
+    bool eliminate(Atom atom) {
+        std::vector<int> pos = occurs[2 * atom], neg = occurs[2 * atom + 1];
+        if(pos.size() + neg.size() > occurrenceLimit)
+            return true;
+
+        std::vector<std::vector<Lit>> resolvents;
+        std::vector<Lit> resolvent;
+        for(int p : pos)
+            for(int n : neg)
+                if(resolve(clauses[p], clauses[n], atom, resolvent)) {
+                    if(resolvent.size() > resolventLimit || resolvents.size() == pos.size() + neg.size())
+                        return true;
+                    resolvents.push_back(resolvent);
+                }
+
+        // Cuvaju se klauze manje brojne polarnosti i jedinicna klauza sa
+        // suprotnim literalom koja odredjuje podrazumevanu vrednost.
+        bool keepPositive = pos.size() <= neg.size();
+        for(int id : keepPositive ? pos : neg) {
+            ClauseRef c = clauses[id];
+            Lit pivot = keepPositive ? 2 * atom : 2 * atom + 1;
+            eliminationStack.push_back(pivot);
+            for(const Lit* l = arena.begin(c); l != arena.end(c); l++)
+                if(*l != pivot)
+                    eliminationStack.push_back(*l);
+            eliminationStack.push_back(arena.size(c));
+        }
+        eliminationStack.push_back(keepPositive ? 2 * atom + 1 : 2 * atom);
+        eliminationStack.push_back(1);
+
+        if(proof)
+            for(const std::vector<Lit>& r : resolvents)
+                proof->add(r.data(), r.data() + r.size());
+        for(int id : pos)
+            removeClause(id);
+        for(int id : neg)
+            removeClause(id);
+        eliminated[atom] = true;
+        atomsEliminated++;
+        for(const std::vector<Lit>& r : resolvents)
+            if(!addClause(r.data(), r.size()))
+                return false;
+        return propagateUnits() && backwardSubsume();
+    }
+
+    // Vraca false ako je formula nezadovoljiva.
+    bool run() {
+        value.assign(atomCount + 1, 0);
+        eliminated.assign(atomCount + 1, false);
+        occurs.assign(2 * atomCount + 2, {});
+        mark.assign(2 * atomCount + 2, 0);
+
+        ClauseArena input = std::move(arena);
+        arena = ClauseArena();
+        arena.memory.reserve(input.memory.size());
+        ClauseRef next;
+        for(ClauseRef c = 0; c < input.memory.size(); c = next) {
+            next = c + ClauseArena::HeaderSize + input.size(c);
+            Lit* first = input.begin(c);
+            Lit* last = input.end(c);
+            std::sort(first, last);
+            last = std::unique(first, last);
+            bool tautology = false;
+            for(Lit* l = first; l + 1 < last; l++)
+                if((*l ^ 1) == l[1])
+                    tautology = true;
+            if(tautology)
+                continue;
+            clausesBefore++;
+            if(!addClause(first, last - first))
+                return false;
+        }
+
+        if(!propagateUnits() || !backwardSubsume())
+            return false;
+
+        std::vector<Atom> order;
+        for(Atom atom = 1; atom <= atomCount; atom++)
+            order.push_back(atom);
+        std::sort(begin(order), end(order), [&](Atom a, Atom b) {
+            return occurs[2 * a].size() + occurs[2 * a + 1].size() < occurs[2 * b].size() + occurs[2 * b + 1].size();
+        });
+        for(Atom atom : order) {
+            if(value[atom] != 0 || eliminated[atom] || occurs[2 * atom].size() + occurs[2 * atom + 1].size() == 0)
+                continue;
+            if(!eliminate(atom))
+                return false;
+        }
+        return true;
+    }
+
+    // Preostala formula, poredjana u novoj areni jedna klauza za drugom.
+    ClauseArena result() {
+        ClauseArena out;
+        for(Atom atom = 1; atom <= atomCount; atom++) {
+            if(value[atom] != 0) {
+                Lit l = value[atom] > 0 ? 2 * atom : 2 * atom + 1;
+                out.add(&l, 1);
+                clausesAfter++;
+            }
+        }
+        for(ClauseRef c : clauses) {
+            if(arena.has(c, ClauseArena::Deleted))
+                continue;
+            out.add(arena.begin(c), arena.size(c));
+            clausesAfter++;
+        }
+        return out;
+    }
+
+    // Dopunjuje model vrednostima eliminisanih atoma, obrnutim redosledom
+    // eliminacije: ako sacuvana klauza nije zadovoljena, njen prvi literal
+    // postaje tacan.
+    void extend(std::vector<signed char>& model) const {
+        size_t i = eliminationStack.size();
+        while(i > 0) {
+            uint32_t size = eliminationStack[--i];
+            i -= size;
+            bool satisfied = false;
+            for(uint32_t k = 0; k < size; k++) {
+                Lit l = eliminationStack[i + k];
+                if(model[atomOf(l)] == (l & 1 ? -1 : 1))
+                    satisfied = true;
+            }
+            if(!satisfied) {
+                Lit pivot = eliminationStack[i];
+                model[atomOf(pivot)] = pivot & 1 ? -1 : 1;
             }
-            else if(value[atom] == (l > 0))
-                return 0;
         }
-        return unit;
     }
+};
+
+struct Options {
+    enum Algorithm { Dpll, Cdcl } algorithm = Cdcl;
+    enum Branching { Linear, Vsids } branching = Vsids;
+    double vsidsDecay = 0.95;
+    bool phaseSaving = true;
+    enum Restarts { NoRestart, Luby, Glucose } restarts = Glucose;
+    long long lubyUnit = 100;
+    double glucoseK = 0.8;
+    int glucoseWindow = 50;
+    bool trailReuse = true;
+    bool reduce = true;
+    long long reduceFirst = 2000;
+    long long reduceIncrement = 300;
+    int coreLbd = 2;
+    int tier2Lbd = 6;
+    bool preprocess = true;
+    bool inprocess = true;
+    long long inprocessInterval = 2000;
+    double inprocessEffort = 0.1;
+    // Lokalna pretraga: samo ona (UNSAT tada ne moze da se dokaze) ili
+    // naizmenicno sa CDCL-om, posle restarta na svakih localInterval
+    // konflikata. Svako pokretanje sme da promeni localFlips atoma (0 znaci
+    // bez ogranicenja).
+    enum LocalMode { NoLocalSearch, LocalOnly, Hybrid } localSearch = NoLocalSearch;
+    long long localFlips = 1000000;
+    long long localInterval = 5000;
+    // Trazenje XOR ogranicenja duzine do xorMaxSize u formuli (iskljuceno uz
+    // DRAT dokaz, jer zakljucci eliminacije nisu RUP).
+    bool xors = true;
+    int xorMaxSize = 6;
+    unsigned seed = 0;
+    bool initialPhase = true;
+    int threads = 1;
+    // Broj kocki za cube-and-conquer (0 iskljucuje taj rezim) i broj atoma
+    // koje lookahead proba u svakom cvoru.
+    int cubes = 0;
+    int lookaheadAtoms = 64;
+    bool progress = false;
+    long long reportInterval = 0;
+};
 
-    Literal hasUnitLiteral(const NormalForm& cnf) {
-        Literal l = 0;
-        for(const Clause& c : cnf)
-            if((l = isUnitClause(c)) != 0)
-                return l;
-        return l;
+std::unique_ptr<RestartPolicy> restartPolicy(const Options& options) {
+    switch(options.restarts) {
+        case Options::NoRestart: return std::make_unique<NoRestarts>();
+        case Options::Luby: return std::make_unique<LubyRestarts>(options.lubyUnit);
+        case Options::Glucose: return std::make_unique<GlucoseRestarts>(options.glucoseK, options.glucoseWindow);
     }
+    return {};
+}
 
-    Literal nextLiteral() {
-        for(int atom = 1; atom < atomCount; atom++)
-            if(value.find(atom) == end(value))
-                return atom;
-        return 0;
+// Da li je neka druga nit portfolija vec nasla odgovor.
+bool stopped(const PartialValuation& valuation) {
+    return valuation.sharing && valuation.sharing->stop.load(std::memory_order_relaxed);
+}
+
+// Lokalna pretraga probSAT nad originalnim klauzama uproscenim dodelom na
+// nivou 0: dok ima nezadovoljenih klauza, bira se slucajna nezadovoljena
+// klauza i u njoj atom koji se menja, sa verovatnocom koja opada sa brojem
+// klauza koje bi promenom postale nezadovoljene (break). Za klauze duzine
+// do 3 verovatnoca je (eps + break)^-cb, a za duze cb^-break.
+struct LocalSearch {
+    // Klauze i liste pojavljivanja su u po jednom nizu: literali klauze i su
+    // lits[clauseStart[i]..clauseStart[i + 1]), a klauze u kojima se javlja
+    // literal l su occurs[occurStart[l]..occurStart[l + 1]).
+    std::vector<Lit> lits;
+    std::vector<uint32_t> clauseStart;
+    std::vector<uint32_t> occurs;
+    std::vector<uint32_t> occurStart;
+    // Za svaku klauzu broj tacnih literala i xor atoma tacnih literala, koji
+    // je, kada je tacan samo jedan literal, bas njegov atom.
+    std::vector<uint32_t> trueCount;
+    std::vector<Atom> critical;
+    // Nezadovoljene klauze i pozicija svake od njih u tom nizu.
+    std::vector<uint32_t> unsat;
+    std::vector<uint32_t> unsatPos;
+    // Za svaki atom broj klauza u kojima je jedini tacan.
+    std::vector<uint32_t> breaks;
+    std::vector<char> assignment;
+    // Najbolja dodela do sada i atomi promenjeni posle nje, da se pri
+    // svakom poboljsanju ne bi kopirala cela dodela.
+    std::vector<char> best;
+    size_t bestUnsat;
+    std::vector<Atom> changed;
+    std::vector<char> dirty;
+    std::vector<double> probability;
+    std::mt19937 rng;
+    long long flips = 0;
+
+    LocalSearch(const PartialValuation& valuation, unsigned seed) : rng(seed) {
+        int atomCount = valuation.atomCount;
+        const ClauseArena& arena = valuation.clauses;
+        std::vector<uint32_t> count(2 * atomCount + 2, 0);
+        size_t maxSize = 0;
+        clauseStart.push_back(0);
+        for(ClauseRef c : valuation.original) {
+            if(arena.has(c, ClauseArena::Deleted))
+                continue;
+            size_t start = lits.size();
+            bool satisfied = false;
+            for(const Lit* l = arena.begin(c); l != arena.end(c) && !satisfied; l++) {
+                signed char v = valuation.value[atomOf(*l)];
+                if(v == 0)
+                    lits.push_back(*l);
+                else
+                    satisfied = (v > 0) == !(*l & 1);
+            }
+            if(satisfied) {
+                lits.resize(start);
+                continue;
+            }
+            for(size_t i = start; i < lits.size(); i++)
+                count[lits[i]]++;
+            maxSize = std::max(maxSize, lits.size() - start);
+            clauseStart.push_back(lits.size());
+        }
+        size_t clauseCount = clauseStart.size() - 1;
+
+        occurStart.assign(2 * atomCount + 3, 0);
+        for(size_t l = 0; l < count.size(); l++)
+            occurStart[l + 1] = occurStart[l] + count[l];
+        occurs.resize(lits.size());
+        std::vector<uint32_t> fill(occurStart.begin(), occurStart.end() - 1);
+        for(size_t i = 0; i < clauseCount; i++)
+            for(uint32_t k = clauseStart[i]; k < clauseStart[i + 1]; k++)
+                occurs[fill[lits[k]]++] = i;
+
+        if(maxSize <= 3) {
+            for(int b = 0; b < 64; b++)
+                probability.push_back(std::pow(0.9 + b, -2.06));
+        }
+        else {
+            double cb = maxSize == 4 ? 3.0 : maxSize == 5 ? 3.7 : maxSize == 6 ? 5.1 : 5.4;
+            for(int b = 0; b < 64; b++)
+                probability.push_back(std::pow(cb, -b));
+        }
+
+        // Pocetna dodela su sacuvane faze.
+        assignment.resize(atomCount + 1);
+        for(Atom atom = 1; atom <= atomCount; atom++)
+            assignment[atom] = valuation.phase[atom];
+        trueCount.assign(clauseCount, 0);
+        critical.assign(clauseCount, 0);
+        unsatPos.assign(clauseCount, 0);
+        breaks.assign(atomCount + 1, 0);
+        for(size_t i = 0; i < clauseCount; i++) {
+            for(uint32_t k = clauseStart[i]; k < clauseStart[i + 1]; k++)
+                if(isTrue(lits[k])) {
+                    trueCount[i]++;
+                    critical[i] ^= atomOf(lits[k]);
+                }
+            if(trueCount[i] == 0) {
+                unsatPos[i] = unsat.size();
+                unsat.push_back(i);
+            }
+            else if(trueCount[i] == 1)
+                breaks[critical[i]]++;
+        }
+        best = assignment;
+        bestUnsat = unsat.size();
+        dirty.assign(atomCount + 1, 0);
+    }
+
+    bool isTrue(Lit l) const {
+        return assignment[atomOf(l)] == !(l & 1);
+    }
+
+    void flip(Atom atom) {
+        Lit now = assignment[atom] ? 2 * atom + 1 : 2 * atom;
+        assignment[atom] ^= 1;
+        flips++;
+        if(!dirty[atom]) {
+            dirty[atom] = 1;
+            changed.push_back(atom);
+        }
+        for(uint32_t k = occurStart[now]; k < occurStart[now + 1]; k++) {
+            uint32_t c = occurs[k];
+            if(++trueCount[c] == 1) {
+                uint32_t last = unsat.back();
+                unsat[unsatPos[c]] = last;
+                unsatPos[last] = unsatPos[c];
+                unsat.pop_back();
+                breaks[atom]++;
+            }
+            else if(trueCount[c] == 2)
+                breaks[critical[c]]--;
+            critical[c] ^= atom;
+        }
+        for(uint32_t k = occurStart[now ^ 1]; k < occurStart[(now ^ 1) + 1]; k++) {
+            uint32_t c = occurs[k];
+            critical[c] ^= atom;
+            if(--trueCount[c] == 0) {
+                unsatPos[c] = unsat.size();
+                unsat.push_back(c);
+                breaks[atom]--;
+            }
+            else if(trueCount[c] == 1)
+                breaks[critical[c]]++;
+        }
+    }
+
+    // Atom iz nezadovoljene klauze c izabran po probSAT pravilu.
+    Atom pick(uint32_t c) {
+        double weights[64];
+        double sum = 0;
+        uint32_t size = std::min<uint32_t>(clauseStart[c + 1] - clauseStart[c], 64);
+        for(uint32_t k = 0; k < size; k++) {
+            uint32_t b = std::min<uint32_t>(breaks[atomOf(lits[clauseStart[c] + k])], probability.size() - 1);
+            sum += weights[k] = probability[b];
+        }
+        double r = std::uniform_real_distribution<double>(0, sum)(rng);
+        uint32_t k = 0;
+        while(k + 1 < size && (r -= weights[k]) > 0)
+            k++;
+        return atomOf(lits[clauseStart[c] + k]);
+    }
+
+    void saveBest() {
+        for(Atom atom : changed) {
+            best[atom] = assignment[atom];
+            dirty[atom] = 0;
+        }
+        changed.clear();
+        bestUnsat = unsat.size();
+    }
+
+    // Menja atome dok ne zadovolji sve klauze, ne potrosi maxFlips promena
+    // (0 znaci bez ogranicenja) ili dok se ne postavi stop. Vraca true ako
+    // je nadjen model, koji je tada u best.
+    bool run(long long maxFlips, const std::atomic<bool>* stop = nullptr) {
+        long long limit = maxFlips ? flips + maxFlips : LLONG_MAX;
+        while(!unsat.empty() && flips < limit) {
+            if(flips % 1024 == 0 && stop && stop->load(std::memory_order_relaxed))
+                break;
+            flip(pick(unsat[rng() % unsat.size()]));
+            if(unsat.size() < bestUnsat)
+                saveBest();
+        }
+        return bestUnsat == 0;
     }
 };
 
-std::optional<PartialValuation> solve(NormalForm& cnf, int atomCount) {
-    PartialValuation valuation;
-    valuation.atomCount = atomCount;
+// Pokrece lokalnu pretragu od sacuvanih faza i najbolju nadjenu dodelu
+// postavlja za nove faze. Ako je to model, svaki propagirani literal se sa
+// njim slaze, pa ga CDCL od nivoa 0 nalazi bez ijednog konflikta. Vraca
+// true ako je nadjen model.
+bool localSearch(PartialValuation& valuation, const Options& options) {
+    auto start = std::chrono::steady_clock::now();
+    valuation.backtrackTo(0);
+    LocalSearch sls(valuation, options.seed + valuation.stats.localSearches);
+    bool found = sls.run(options.localFlips, valuation.sharing ? &valuation.sharing->stop : nullptr);
+    for(Atom atom = 1; atom <= valuation.atomCount; atom++)
+        if(valuation.value[atom] == 0)
+            valuation.phase[atom] = sls.best[atom];
+    valuation.stats.localSearches++;
+    valuation.stats.localFlips += sls.flips;
+    valuation.stats.localBestUnsat = sls.bestUnsat;
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    valuation.stats.localTime += time.count();
+    return found;
+}
 
-    Literal l;
+// DPLL sa hronoloskim bektrekingom: menja se samo poslednja odluka.
+// Pretpostavke se ne menjaju, pa konflikt na njihovim nivoima znaci UNSAT.
+Result solveDpll(PartialValuation& valuation) {
+    if(valuation.inconsistent)
+        return Unsat;
+    Lit l;
     while(true) {
-        valuation.print();
-
-        if(valuation.hasConflict(cnf)) {
+        if(valuation.propagate() != NoClause) {
+            valuation.stats.conflicts++;
+            if(valuation.reportInterval && valuation.stats.conflicts % valuation.reportInterval == 0)
+                valuation.report();
+            if(valuation.decisionLevel() == 0)
+                valuation.inconsistent = true;
+            if(valuation.decisionLevel() <= (int)valuation.assumptions.size()) {
+                auto first = begin(valuation.assumptions);
+                valuation.failed.assign(first, first + valuation.decisionLevel());
+                return Unsat;
+            }
+            if(stopped(valuation))
+                return Unknown;
             l = valuation.backtrack();
-            if(l == 0)
-                break;
-            valuation.push(-l, false);
+            valuation.push(l ^ 1, false);
+        }
+        else if(valuation.decisionLevel() < (int)valuation.assumptions.size()) {
+            if(!valuation.assume())
+                return Unsat;
         }
-        else if((l = valuation.hasUnitLiteral(cnf)) != 0)
-            valuation.push(l, false);
         else if((l = valuation.nextLiteral()) != 0)
             valuation.push(l, true);
         else
-            return valuation;
+            return Sat;
     }
-    return {};
 }
 
-NormalForm parse(std::istream& fin, int& atomCount) {
-    std::string buffer;
-    do {
-        fin >> buffer;
-        if(buffer == "c")
-            fin.ignore(10000, '\n');
-    } while(buffer != "p");
+// CDCL: iz svakog konflikta se uci nova klauza i skace se na nivo na kome
+// ona postaje jedinicna. U portfoliju se klauze drugih niti preuzimaju pri
+// restartu, a posle restarta se, kada dodje red, pokrece inprocesiranje i
+// u hibridnom rezimu lokalna pretraga.
+// Ako je neka pretpostavka netacna, rezultat je UNSAT.
+Result solveCdcl(PartialValuation& valuation, const Options& options) {
+    if(valuation.inconsistent)
+        return Unsat;
+    std::unique_ptr<RestartPolicy> restarts = restartPolicy(options);
+    std::vector<Lit> learnt;
+    Lit l;
+    while(true) {
+        ClauseRef conflict = valuation.propagate();
+        if(conflict != NoClause) {
+            valuation.stats.conflicts++;
+            if(valuation.reportInterval && valuation.stats.conflicts % valuation.reportInterval == 0)
+                valuation.report();
+            if(valuation.decisionLevel() == 0) {
+                valuation.inconsistent = true;
+                return Unsat;
+            }
+            if(stopped(valuation))
+                return Unknown;
+            int lvl = valuation.analyze(conflict, learnt);
+            valuation.heuristic->decay();
+            valuation.db.decay();
+            uint32_t lbd = valuation.lbd(learnt.data(), learnt.data() + learnt.size());
+            restarts->conflict(lbd, valuation.trail.size());
+            valuation.backtrackTo(lvl);
+            valuation.learn(learnt, lbd);
+        }
+        else if(valuation.db.reduce && valuation.stats.conflicts >= valuation.db.nextReduce)
+            valuation.reduceDb();
+        else if(restarts->shouldRestart()) {
+            valuation.restart(options.trailReuse);
+            restarts->restarted();
+            if(valuation.sharing && !valuation.importClauses())
+                return Unsat;
+            if(valuation.inprocessing.enabled && valuation.stats.conflicts >= valuation.inprocessing.next
+               && !valuation.inprocess())
+                return Unsat;
+            if(options.localSearch == Options::Hybrid && valuation.stats.conflicts >= valuation.nextLocalSearch) {
+                valuation.nextLocalSearch = valuation.stats.conflicts + options.localInterval;
+                localSearch(valuation, options);
+            }
+        }
+        else if(valuation.decisionLevel() < (int)valuation.assumptions.size()) {
+            if(!valuation.assume())
+                return Unsat;
+        }
+        else if((l = valuation.nextLiteral()) != 0)
+            valuation.push(l, true);
+        else
+            return Sat;
+    }
+}
+
+// Pokrece preprocesiranje ako je ukljuceno i formulu zamenjuje
+// uproscenom. Vraca false ako je vec tada formula nezadovoljiva.
+bool preprocess(ClauseArena& formula, int atomCount, const Options& options,
+                std::optional<Preprocessor>& preprocessor, Statistics& stats, ProofWriter* proof = nullptr) {
+    if(!options.preprocess)
+        return true;
+    auto start = std::chrono::steady_clock::now();
+    preprocessor.emplace(std::move(formula), atomCount);
+    preprocessor->proof = proof;
+    bool ok = preprocessor->run();
+    formula = preprocessor->result();
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    stats.preprocessTime = time.count();
+    stats.preprocessRemovedClauses = preprocessor->clausesBefore - preprocessor->clausesAfter;
+    stats.preprocessEliminatedAtoms = preprocessor->atomsEliminated;
+    return ok;
+}
+
+// Postavlja resavac nad formulom prema opcijama i trazi XOR ogranicenja u
+// njoj. Vraca false ako init() vec pronadje praznu ili dve suprotne
+// jedinicne klauze ili ako je sistem XOR ogranicenja protivrecan.
+bool configure(PartialValuation& valuation, ClauseArena formula, int atomCount, const Options& options) {
+    valuation.atomCount = atomCount;
+    valuation.clauses = std::move(formula);
+    valuation.phaseSaving = options.phaseSaving;
+    valuation.initialPhase = options.initialPhase;
+    valuation.reportInterval = options.reportInterval;
+    valuation.db.reduce = options.reduce;
+    valuation.db.reduceFirst = valuation.db.nextReduce = options.reduceFirst;
+    valuation.db.reduceIncrement = options.reduceIncrement;
+    valuation.db.coreLbd = options.coreLbd;
+    valuation.db.tier2Lbd = options.tier2Lbd;
+    valuation.inprocessing.enabled = options.inprocess;
+    valuation.inprocessing.interval = valuation.inprocessing.next = options.inprocessInterval;
+    valuation.inprocessing.effort = options.inprocessEffort;
+    if(options.branching == Options::Linear)
+        valuation.heuristic = std::make_unique<LinearHeuristic>();
+    else
+        valuation.heuristic = std::make_unique<VsidsHeuristic>(options.vsidsDecay, options.seed);
+    if(!valuation.init())
+        return false;
+    if(options.xors && !valuation.proof)
+        valuation.detectXors(options.xorMaxSize);
+    // Zamenjeni atomi bi ostali u XOR redovima.
+    if(!valuation.gauss.xors.empty())
+        valuation.inprocessing.substitute = false;
+    return valuation.initGauss();
+}
+
+// U rezimu samo lokalne pretrage model koji ona nadje dovrsava resavac bez
+// ijednog konflikta, a ako ga ne nadje, rezultat je Unknown.
+Result search(PartialValuation& valuation, const Options& options) {
+    auto start = std::chrono::steady_clock::now();
+    Result result;
+    if(options.localSearch == Options::LocalOnly && !localSearch(valuation, options))
+        result = Unknown;
+    else if(options.algorithm == Options::Dpll)
+        result = solveDpll(valuation);
+    else
+        result = solveCdcl(valuation, options);
+    if(result == Sat)
+        valuation.fillSubstituted();
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    valuation.stats.searchTime += time.count();
+    return result;
+}
+
+// Ako je zadat proof, u njega se upisuje DRAT dokaz (samo za CDCL, jer
+// DPLL ne uci klauze) koji se za UNSAT zavrsava praznom klauzom.
+std::optional<PartialValuation> solve(ClauseArena formula, int atomCount, const Options& options = {},
+                                      Statistics* stats = nullptr, ProofWriter* proof = nullptr) {
+    PartialValuation valuation;
+    valuation.proof = proof;
+    std::optional<Preprocessor> preprocessor;
+    bool ok = preprocess(formula, atomCount, options, preprocessor, valuation.stats, proof)
+        && configure(valuation, std::move(formula), atomCount, options);
+    Result result = ok ? search(valuation, options) : Unsat;
+    if(result == Unsat && proof)
+        proof->add(nullptr, nullptr);
+    if(stats)
+        *stats = valuation.stats;
+    if(result != Sat)
+        return {};
+    if(preprocessor)
+        preprocessor->extend(valuation.value);
+    return valuation;
+}
 
-    // procitaj "cnf"
-    fin >> buffer;
+// Inkrementalni resavac: jedna PartialValuation traje kroz sve pozive, pa
+// naucene klauze, aktivnosti i sacuvane faze ostaju od poziva do poziva.
+// Klauze i XOR ogranicenja se mogu dodavati izmedju poziva, a svaki poziv
+// moze da zada pretpostavke. Preprocesiranje i zamena ekvivalentnih
+// literala se ne koriste, jer bi eliminisani i zamenjeni atomi mogli da se
+// pojave u kasnije dodatim klauzama.
+struct Solver {
+    Options options;
+    PartialValuation valuation;
+    // Model poslednjeg SAT odgovora, indeksiran atomom.
+    std::vector<signed char> model;
+    // Posle UNSAT odgovora: podskup pretpostavki koji je vec nezadovoljiv
+    // uz formulu. Prazan je ako je formula nezadovoljiva sama po sebi.
+    std::vector<Literal> core;
 
-    int clauseCount;
-    fin >> atomCount >> clauseCount;
+    explicit Solver(const Options& options = {}, int atomCount = 0) : options(options) {
+        configure(valuation, ClauseArena(), atomCount, options);
+        valuation.inprocessing.substitute = false;
+    }
 
-    NormalForm formula;
-    for(int i = 0; i < clauseCount; i++) {
-        Clause c;
+    int atomCount() const {
+        return valuation.atomCount;
+    }
 
-        Literal l;
-        fin >> l;
-        while(l != 0) {
-            c.push_back(l);
-            fin >> l;
+    // Dodaje XOR ogranicenje: XOR literala je parity. Ogranicenje se ne
+    // zapisuje klauzama, vec ga propagira Gaus-Zordanova eliminacija.
+    void addXor(const Clause& literals, bool parity = true) {
+        Xor x{{}, parity, true};
+        for(Literal l : literals) {
+            x.atoms.push_back(std::abs(l));
+            x.rhs ^= l < 0;
+        }
+        std::sort(begin(x.atoms), end(x.atoms));
+        // Atom koji se javlja dva puta se potire.
+        size_t j = 0;
+        for(size_t i = 0; i < x.atoms.size(); i++) {
+            if(i + 1 < x.atoms.size() && x.atoms[i] == x.atoms[i + 1])
+                i++;
+            else
+                x.atoms[j++] = x.atoms[i];
+        }
+        x.atoms.resize(j);
+        valuation.grow(x.atoms.empty() ? 0 : x.atoms.back());
+        valuation.gauss.xors.push_back(x);
+        valuation.gauss.dirty = true;
+    }
+
+    void addClause(const Clause& clause) {
+        std::vector<Lit> lits;
+        int atoms = 0;
+        for(Literal l : clause) {
+            lits.push_back(toLit(l));
+            atoms = std::max(atoms, std::abs(l));
+        }
+        valuation.grow(atoms);
+        valuation.addClause(lits);
+    }
+
+    bool solve(const std::vector<Literal>& assumptions = {}) {
+        valuation.backtrackTo(0);
+        valuation.assumptions.clear();
+        for(Literal l : assumptions) {
+            valuation.grow(std::abs(l));
+            valuation.assumptions.push_back(toLit(l));
+        }
+        valuation.failed.clear();
+        core.clear();
+        if(valuation.gauss.dirty)
+            valuation.initGauss();
+        if(search(valuation, options) == Sat) {
+            model = valuation.value;
+            return true;
+        }
+        for(Lit l : valuation.failed)
+            core.push_back(toLiteral(l));
+        return false;
+    }
+
+    // Vrednost DIMACS literala u modelu poslednjeg SAT odgovora.
+    bool value(Literal l) const {
+        return model[std::abs(l)] == (l > 0 ? 1 : -1);
+    }
+};
+
+// Podesavanja i-te niti portfolija. Nit 0 radi sa zadatim opcijama, a
+// ostale menjaju seme, pocetnu fazu, faktor opadanja aktivnosti i
+// politiku restarta.
+Options workerOptions(const Options& options, int i) {
+    Options worker = options;
+    if(i == 0)
+        return worker;
+    const double decays[] = {0.95, 0.9, 0.85, 0.99};
+    worker.seed = options.seed + i;
+    worker.initialPhase = i % 2 == 0;
+    worker.vsidsDecay = decays[i % 4];
+    worker.restarts = i % 3 == 1 ? Options::Luby : Options::Glucose;
+    worker.lubyUnit = 100 << (i / 3 % 3);
+    return worker;
+}
+
+// Lookahead deli formulu na kocke (skupove pretpostavki). U svakom cvoru
+// se za najcesce slobodne atome propagiraju oba literala i grana se po
+// atomu sa najvecim proizvodom broja propagiranih literala. Literal cija
+// propagacija dovodi do konflikta je neuspeo, pa se dodeljuje njegova
+// negacija; cvor u kome su oba literala neuspela je odbacen.
+struct Cuber {
+    PartialValuation& valuation;
+    std::vector<Atom> order;
+    size_t lookaheadAtoms;
+    size_t maxDepth;
+    std::vector<Lit> cube;
+    std::vector<std::vector<Lit>> cubes;
+    long long refuted = 0;
+
+    Cuber(PartialValuation& valuation, size_t cubeCount, size_t lookaheadAtoms)
+        : valuation(valuation), lookaheadAtoms(lookaheadAtoms), maxDepth(0) {
+        while(((size_t)1 << maxDepth) < cubeCount)
+            maxDepth++;
+        std::vector<int> occurrences(valuation.atomCount + 1, 0);
+        for(ClauseRef c : valuation.original)
+            for(const Lit* l = valuation.clauses.begin(c); l != valuation.clauses.end(c); l++)
+                occurrences[atomOf(*l)]++;
+        for(Atom atom = 1; atom <= valuation.atomCount; atom++)
+            if(occurrences[atom] > 0)
+                order.push_back(atom);
+        std::stable_sort(begin(order), end(order), [&](Atom a, Atom b) {
+            return occurrences[a] > occurrences[b];
+        });
+    }
+
+    // Broj literala koje dodeljuje propagacija literala l, odnosno -1 ako
+    // ona dovodi do konflikta.
+    long long look(Lit l) {
+        int lvl = valuation.decisionLevel();
+        size_t before = valuation.trail.size();
+        valuation.push(l, true);
+        bool conflict = valuation.propagate() != NoClause;
+        long long count = valuation.trail.size() - before;
+        valuation.backtrackTo(lvl);
+        return conflict ? -1 : count;
+    }
+
+    void split() {
+        if(valuation.propagate() != NoClause) {
+            refuted++;
+            return;
+        }
+        if(cube.size() >= maxDepth) {
+            cubes.push_back(cube);
+            return;
+        }
+
+        Atom best = 0;
+        long long bestScore = -1;
+        size_t tried = 0;
+        for(size_t i = 0; i < order.size() && tried < lookaheadAtoms; i++) {
+            Atom atom = order[i];
+            if(valuation.value[atom] != 0)
+                continue;
+            tried++;
+            long long pos = look(2 * atom), neg = look(2 * atom + 1);
+            if(pos < 0 || neg < 0) {
+                if(pos < 0 && neg < 0) {
+                    refuted++;
+                    return;
+                }
+                valuation.push(pos < 0 ? 2 * atom + 1 : 2 * atom, false);
+                if(valuation.propagate() != NoClause) {
+                    refuted++;
+                    return;
+                }
+                continue;
+            }
+            long long score = (pos + 1) * (neg + 1);
+            if(score > bestScore) {
+                best = atom;
+                bestScore = score;
+            }
+        }
+        if(best == 0 || valuation.value[best] != 0) {
+            cubes.push_back(cube);
+            return;
+        }
+
+        int lvl = valuation.decisionLevel();
+        for(Lit l : {(Lit)(2 * best), (Lit)(2 * best + 1)}) {
+            valuation.push(l, true);
+            cube.push_back(l);
+            split();
+            cube.pop_back();
+            valuation.backtrackTo(lvl);
         }
+    }
+};
+
+// Red kocki jedne niti. Nit uzima kocke sa pocetka svog reda, a kada ga
+// isprazni, krade sa kraja reda neke druge niti.
+struct CubeQueue {
+    std::mutex mutex;
+    std::deque<int> cubes;
+};
+
+// Cube-and-conquer: lookahead deli formulu na oko options.cubes kocki, a
+// options.threads niti ih resava CDCL-om (ili DPLL-om) pod
+// pretpostavkama. Svaka nit koristi jedan resavac za sve svoje kocke, pa
+// zadrzava naucene klauze, i deli ih sa ostalim nitima kao u portfoliju.
+// Prva zadovoljiva kocka zaustavlja sve niti.
+std::optional<PartialValuation> solveCubes(ClauseArena formula, int atomCount, const Options& options,
+                                           std::vector<Statistics>* workers = nullptr) {
+    int threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    Statistics cubeStats;
+    std::optional<Preprocessor> preprocessor;
+    bool ok = preprocess(formula, atomCount, options, preprocessor, cubeStats);
+
+    std::vector<std::vector<Lit>> cubes;
+    if(ok) {
+        auto start = std::chrono::steady_clock::now();
+        Options lookahead = options;
+        lookahead.branching = Options::Linear;
+        PartialValuation valuation;
+        ok = configure(valuation, formula, atomCount, lookahead);
+        if(ok) {
+            Cuber cuber(valuation, options.cubes, options.lookaheadAtoms);
+            cuber.split();
+            cubes = std::move(cuber.cubes);
+            cubeStats.cubesRefuted = cuber.refuted;
+        }
+        cubeStats.cubes = cubes.size();
+        std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        cubeStats.cubeTime = time.count();
+    }
+
+    std::vector<PartialValuation> valuations(threads);
+    std::vector<CubeQueue> queues(threads);
+    for(size_t i = 0; i < cubes.size(); i++)
+        queues[i * threads / cubes.size()].cubes.push_back(i);
+    Sharing sharing(threads);
+    std::atomic<int> winner{-1};
+    std::atomic<long long> refuted{0};
+    std::mutex output;
+    auto take = [&](int i) {
+        for(int k = 0; k < threads; k++) {
+            CubeQueue& queue = queues[(i + k) % threads];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if(queue.cubes.empty())
+                continue;
+            int cube;
+            if(k == 0) {
+                cube = queue.cubes.front();
+                queue.cubes.pop_front();
+            }
+            else {
+                cube = queue.cubes.back();
+                queue.cubes.pop_back();
+            }
+            return cube;
+        }
+        return -1;
+    };
+
+    if(!cubes.empty()) {
+        std::vector<std::thread> pool;
+        for(int i = 0; i < threads; i++) {
+            pool.emplace_back([&, i]() {
+                PartialValuation& valuation = valuations[i];
+                valuation.stats = cubeStats;
+                valuation.sharing = &sharing;
+                valuation.worker = i;
+                valuation.cursors.assign(threads, 0);
+                if(!configure(valuation, formula, atomCount, options))
+                    valuation.inconsistent = true;
+                int cube;
+                while(!sharing.stop.load(std::memory_order_relaxed) && (cube = take(i)) != -1) {
+                    valuation.backtrackTo(0);
+                    valuation.assumptions = cubes[cube];
+                    Result result = search(valuation, options);
+                    if(result == Unknown)
+                        break;
+                    int none = -1;
+                    if(result == Sat || valuation.inconsistent) {
+                        if(winner.compare_exchange_strong(none, i))
+                            sharing.stop.store(true, std::memory_order_relaxed);
+                        break;
+                    }
+                    long long done = ++refuted;
+                    if(options.progress && done * 100 / cubes.size() > (done - 1) * 100 / cubes.size()) {
+                        std::lock_guard<std::mutex> lock(output);
+                        std::cout << "c progress: " << done << "/" << cubes.size() << " cubes refuted ("
+                                  << done * 100 / cubes.size() << "%)" << std::endl;
+                    }
+                }
+            });
+        }
+        for(std::thread& t : pool)
+            t.join();
+    }
+
+    if(workers) {
+        workers->clear();
+        for(PartialValuation& valuation : valuations)
+            workers->push_back(cubes.empty() ? cubeStats : valuation.stats);
+    }
+    if(winner == -1 || valuations[winner].inconsistent)
+        return {};
+    PartialValuation& valuation = valuations[winner];
+    if(preprocessor)
+        preprocessor->extend(valuation.value);
+    return std::move(valuation);
+}
 
-        formula.push_back(c);
+// Portfolio: options.threads (0 znaci broj hardverskih niti) razlicito
+// podesenih resavaca radi nad istom, jednom preprocesiranom formulom i
+// razmenjuje kratke naucene klauze sa malim LBD-om. Prva nit koja nadje
+// odgovor zaustavlja ostale. U workers se upisuje statistika svake niti.
+std::optional<PartialValuation> solvePortfolio(ClauseArena formula, int atomCount, const Options& options,
+                                               std::vector<Statistics>* workers = nullptr) {
+    int threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    Statistics preprocessStats;
+    std::optional<Preprocessor> preprocessor;
+    bool ok = preprocess(formula, atomCount, options, preprocessor, preprocessStats);
+
+    std::vector<PartialValuation> valuations(threads);
+    std::vector<Result> results(threads, Unknown);
+    Sharing sharing(threads);
+    std::atomic<int> winner{-1};
+    if(ok) {
+        std::vector<std::thread> pool;
+        for(int i = 0; i < threads; i++) {
+            pool.emplace_back([&, i]() {
+                Options worker = workerOptions(options, i);
+                PartialValuation& valuation = valuations[i];
+                valuation.stats = preprocessStats;
+                valuation.sharing = &sharing;
+                valuation.worker = i;
+                valuation.cursors.assign(threads, 0);
+                results[i] = configure(valuation, formula, atomCount, worker) ? search(valuation, worker) : Unsat;
+                int none = -1;
+                if(results[i] != Unknown && winner.compare_exchange_strong(none, i))
+                    sharing.stop.store(true, std::memory_order_relaxed);
+            });
+        }
+        for(std::thread& t : pool)
+            t.join();
     }
 
-    return formula;
+    if(workers) {
+        workers->clear();
+        for(PartialValuation& valuation : valuations)
+            workers->push_back(ok ? valuation.stats : preprocessStats);
+    }
+    // Bez pobednika (nijedna nit nije dala odgovor) nema modela.
+    if(!ok || winner == -1 || results[winner] != Sat)
+        return {};
+    PartialValuation& valuation = valuations[winner];
+    if(preprocessor)
+        preprocessor->extend(valuation.value);
+    return std::move(valuation);
 }
 
-int main() {
+// Formula procitana iz DIMACS-a. Parser upisuje klauze direktno u arenu.
+struct Dimacs {
     int atomCount = 0;
-    NormalForm formula = parse(std::cin, atomCount);
+    int clauseCount = 0;
+    ClauseArena formula;
+};
+
+// Parsira DIMACS iz memorije. Komentari mogu da se pojave bilo gde, broj
+// atoma i klauza iz zaglavlja sluzi samo kao procena, a '%' (kao u SATLIB
+// fajlovima) oznacava kraj formule.
+bool parse(const char* p, const char* end, Dimacs& dimacs) {
+    auto skipSpace = [&]() {
+        while(p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+            p++;
+    };
+    auto readInt = [&](int& x) {
+        skipSpace();
+        bool negative = p < end && *p == '-';
+        if(negative)
+            p++;
+        if(p == end || *p < '0' || *p > '9')
+            return false;
+        x = 0;
+        while(p < end && *p >= '0' && *p <= '9')
+            x = 10 * x + (*p++ - '0');
+        if(negative)
+            x = -x;
+        return true;
+    };
+
+    std::vector<uint32_t>& memory = dimacs.formula.memory;
+    size_t open = SIZE_MAX;
+    auto close = [&]() {
+        memory[open] = memory.size() - open - ClauseArena::HeaderSize;
+        dimacs.clauseCount++;
+        open = SIZE_MAX;
+    };
+    while(true) {
+        skipSpace();
+        if(p == end || *p == '%')
+            break;
+        if(*p == 'c') {
+            p = (const char*)std::memchr(p, '\n', end - p);
+            if(p == nullptr)
+                p = end;
+            continue;
+        }
+        if(*p == 'p') {
+            p++;
+            skipSpace();
+            if(end - p < 3 || std::strncmp(p, "cnf", 3) != 0)
+                return false;
+            p += 3;
+            int atoms, clauses;
+            if(!readInt(atoms) || !readInt(clauses))
+                return false;
+            dimacs.atomCount = std::max(dimacs.atomCount, atoms);
+            memory.reserve(memory.size() + (ClauseArena::HeaderSize + 3) * (size_t)clauses);
+            continue;
+        }
+
+        Literal l;
+        if(!readInt(l))
+            return false;
+        if(open == SIZE_MAX)
+            open = dimacs.formula.add(nullptr, 0);
+        if(l == 0)
+            close();
+        else {
+            memory.push_back(toLit(l));
+            dimacs.atomCount = std::max(dimacs.atomCount, std::abs(l));
+        }
+    }
+    if(open != SIZE_MAX)
+        close();
+    return true;
+}
+
+// Fajl se mapira u memoriju i parsira bez kopiranja. Ako putanja nije
+// zadata, ceo standardni ulaz se ucitava u bafer.
+bool parseFile(const std::string& path, Dimacs& dimacs, size_t& bytes) {
+    if(path.empty()) {
+        std::string buffer;
+        char chunk[1 << 16];
+        size_t n;
+        while((n = std::fread(chunk, 1, sizeof chunk, stdin)) > 0)
+            buffer.append(chunk, n);
+        bytes = buffer.size();
+        return parse(buffer.data(), buffer.data() + buffer.size(), dimacs);
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    bytes = st.st_size;
+    if(bytes == 0) {
+        ::close(fd);
+        return true;
+    }
+    void* data = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(data == MAP_FAILED)
+        return false;
+    madvise(data, bytes, MADV_SEQUENTIAL);
+    const char* begin = static_cast<const char*>(data);
+    bool ok = parse(begin, begin + bytes, dimacs);
+    munmap(data, bytes);
+    return ok;
+}
+
+// Za argument oblika --name=value upisuje value i vraca true.
+bool option(const std::string& arg, const std::string& name, std::string& value) {
+    if(arg.compare(0, name.size() + 1, name + "=") != 0)
+        return false;
+    value = arg.substr(name.size() + 1);
+    return true;
+}
 
-    auto valuation = solve(formula, atomCount);
-    if(valuation)
-        std::cout << "SAT" << std::endl;
+// Zavrsna statistika kao jedan JSON objekat: rezultat, parsiranje i
+// brojaci svake niti (jedne ako resavac radi sekvencijalno).
+void writeJson(std::ostream& out, const std::string& result, size_t bytes, double parseTime,
+               const std::vector<Statistics>& stats) {
+    out << "{\"result\": \"" << result << "\", \"bytes\": " << bytes
+        << ", \"parse_time\": " << parseTime << ", \"workers\": [";
+    for(size_t i = 0; i < stats.size(); i++) {
+        const Statistics& s = stats[i];
+        out << (i ? ", " : "") << "{"
+            << "\"decisions\": " << s.decisions
+            << ", \"propagations\": " << s.propagations
+            << ", \"conflicts\": " << s.conflicts
+            << ", \"restarts\": " << s.restarts
+            << ", \"learnt\": " << s.learnt
+            << ", \"deleted\": " << s.deleted
+            << ", \"reductions\": " << s.reductions
+            << ", \"exported\": " << s.exported
+            << ", \"imported\": " << s.imported
+            << ", \"preprocess_removed_clauses\": " << s.preprocessRemovedClauses
+            << ", \"preprocess_eliminated_atoms\": " << s.preprocessEliminatedAtoms
+            << ", \"inprocessings\": " << s.inprocessings
+            << ", \"failed_literals\": " << s.failedLiterals
+            << ", \"vivified_clauses\": " << s.vivifiedClauses
+            << ", \"vivified_literals\": " << s.vivifiedLiterals
+            << ", \"substituted_atoms\": " << s.substitutedAtoms
+            << ", \"xor_constraints\": " << s.xorConstraints
+            << ", \"xor_matrices\": " << s.xorMatrices
+            << ", \"xor_propagations\": " << s.xorPropagations
+            << ", \"xor_conflicts\": " << s.xorConflicts
+            << ", \"local_searches\": " << s.localSearches
+            << ", \"local_flips\": " << s.localFlips
+            << ", \"local_best_unsat\": " << s.localBestUnsat
+            << ", \"cubes\": " << s.cubes
+            << ", \"cubes_refuted\": " << s.cubesRefuted
+            << ", \"preprocess_time\": " << s.preprocessTime
+            << ", \"cube_time\": " << s.cubeTime
+            << ", \"probe_time\": " << s.probeTime
+            << ", \"vivify_time\": " << s.vivifyTime
+            << ", \"substitute_time\": " << s.substituteTime
+            << ", \"local_time\": " << s.localTime
+            << ", \"search_time\": " << s.searchTime
+            << ", \"propagate_time\": " << s.propagateTime
+            << ", \"analyze_time\": " << s.analyzeTime
+            << ", \"reduce_time\": " << s.reduceTime
+            << "}";
+    }
+    out << "]}" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    bool printStats = false;
+    std::string jsonPath;
+    std::string proofPath;
+    bool proofPipe = false;
+    bool proofBinary = true;
+    std::string path;
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i], value;
+        if(arg.empty() || arg[0] != '-')
+            path = arg;
+        else if(arg == "--dpll")
+            options.algorithm = Options::Dpll;
+        else if(arg == "--cdcl")
+            options.algorithm = Options::Cdcl;
+        else if(arg == "--branching=linear")
+            options.branching = Options::Linear;
+        else if(arg == "--branching=vsids")
+            options.branching = Options::Vsids;
+        else if(option(arg, "--vsids-decay", value))
+            options.vsidsDecay = std::stod(value);
+        else if(arg == "--no-phase-saving")
+            options.phaseSaving = false;
+        else if(arg == "--restarts=none")
+            options.restarts = Options::NoRestart;
+        else if(arg == "--restarts=luby")
+            options.restarts = Options::Luby;
+        else if(arg == "--restarts=glucose")
+            options.restarts = Options::Glucose;
+        else if(option(arg, "--luby-unit", value))
+            options.lubyUnit = std::stoll(value);
+        else if(option(arg, "--glucose-k", value))
+            options.glucoseK = std::stod(value);
+        else if(option(arg, "--glucose-window", value))
+            options.glucoseWindow = std::stoi(value);
+        else if(arg == "--no-trail-reuse")
+            options.trailReuse = false;
+        else if(arg == "--no-reduce")
+            options.reduce = false;
+        else if(option(arg, "--reduce-first", value))
+            options.reduceFirst = std::stoll(value);
+        else if(option(arg, "--reduce-increment", value))
+            options.reduceIncrement = std::stoll(value);
+        else if(option(arg, "--core-lbd", value))
+            options.coreLbd = std::stoi(value);
+        else if(option(arg, "--tier2-lbd", value))
+            options.tier2Lbd = std::stoi(value);
+        else if(arg == "--no-preprocess")
+            options.preprocess = false;
+        else if(arg == "--no-inprocess")
+            options.inprocess = false;
+        else if(option(arg, "--inprocess-interval", value))
+            options.inprocessInterval = std::stoll(value);
+        else if(option(arg, "--inprocess-effort", value))
+            options.inprocessEffort = std::stod(value);
+        else if(arg == "--local-search=only")
+            options.localSearch = Options::LocalOnly;
+        else if(arg == "--local-search=hybrid")
+            options.localSearch = Options::Hybrid;
+        else if(option(arg, "--local-flips", value))
+            options.localFlips = std::stoll(value);
+        else if(option(arg, "--local-interval", value))
+            options.localInterval = std::stoll(value);
+        else if(arg == "--no-xor")
+            options.xors = false;
+        else if(option(arg, "--xor-max-size", value))
+            options.xorMaxSize = std::stoi(value);
+        else if(option(arg, "--threads", value))
+            options.threads = std::stoi(value);
+        else if(option(arg, "--seed", value))
+            options.seed = std::stoul(value);
+        else if(option(arg, "--cubes", value))
+            options.cubes = std::stoi(value);
+        else if(option(arg, "--lookahead", value))
+            options.lookaheadAtoms = std::stoi(value);
+        else if(arg == "--progress")
+            options.progress = true;
+        else if(arg == "--stats")
+            printStats = true;
+        else if(option(arg, "--stats-json", value))
+            jsonPath = value;
+        else if(option(arg, "--report", value))
+            options.reportInterval = std::stoll(value);
+        else if(option(arg, "--proof", value))
+            proofPath = value;
+        else if(option(arg, "--proof-pipe", value)) {
+            proofPath = value;
+            proofPipe = true;
+        }
+        else if(arg == "--proof-text")
+            proofBinary = false;
+        else {
+            std::cerr << "Nepoznata opcija: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::unique_ptr<ProofWriter> proof;
+    if(!proofPath.empty()) {
+        if(options.algorithm == Options::Dpll || options.threads != 1 || options.cubes > 0
+           || options.localSearch == Options::LocalOnly) {
+            std::cerr << "DRAT dokaz je podrzan samo za sekvencijalni CDCL" << std::endl;
+            return 1;
+        }
+        proof = std::make_unique<ProofWriter>(proofPath, proofPipe, proofBinary);
+        if(!proof->ok()) {
+            std::cerr << "Neuspesno otvaranje dokaza: " << proofPath << std::endl;
+            return 1;
+        }
+    }
+
+    Dimacs dimacs;
+    size_t bytes = 0;
+    auto parseStart = std::chrono::steady_clock::now();
+    if(!parseFile(path, dimacs, bytes)) {
+        std::cerr << "Neispravan DIMACS ulaz: " << (path.empty() ? "stdin" : path) << std::endl;
+        return 1;
+    }
+    std::chrono::duration<double> parseTime = std::chrono::steady_clock::now() - parseStart;
+    std::vector<Statistics> stats(1);
+    std::optional<PartialValuation> valuation;
+    if(options.cubes > 0)
+        valuation = solveCubes(std::move(dimacs.formula), dimacs.atomCount, options, &stats);
+    else if(options.threads != 1)
+        valuation = solvePortfolio(std::move(dimacs.formula), dimacs.atomCount, options, &stats);
     else
-        std::cout << "UNSAT" << std::endl;
+        valuation = solve(std::move(dimacs.formula), dimacs.atomCount, options, &stats[0], proof.get());
+    proof.reset();
+    if(printStats) {
+        double megabytes = bytes / 1e6;
+        std::cout << "c parse: " << megabytes << " MB, " << parseTime.count() << " s, "
+                  << megabytes / std::max(parseTime.count(), 1e-9) << " MB/s" << std::endl;
+        std::cout << "c preprocess: " << stats[0].preprocessRemovedClauses << " clauses removed, "
+                  << stats[0].preprocessEliminatedAtoms << " atoms eliminated, "
+                  << stats[0].preprocessTime << " s" << std::endl;
+        if(options.cubes > 0)
+            std::cout << "c cubes: " << stats[0].cubes << " cubes, " << stats[0].cubesRefuted
+                      << " refuted by lookahead, " << stats[0].cubeTime << " s" << std::endl;
+        for(size_t i = 0; i < stats.size(); i++) {
+            std::string prefix = stats.size() > 1 ? "c worker " + std::to_string(i) + " " : "c ";
+            std::cout << prefix << "decisions: " << stats[i].decisions << std::endl;
+            std::cout << prefix << "propagations: " << stats[i].propagations << std::endl;
+            std::cout << prefix << "conflicts: " << stats[i].conflicts << std::endl;
+            std::cout << prefix << "restarts: " << stats[i].restarts << std::endl;
+            std::cout << prefix << "learnt: " << stats[i].learnt << std::endl;
+            std::cout << prefix << "deleted: " << stats[i].deleted << std::endl;
+            std::cout << prefix << "reductions: " << stats[i].reductions << std::endl;
+            std::cout << prefix << "inprocessings: " << stats[i].inprocessings << std::endl;
+            std::cout << prefix << "probe: " << stats[i].failedLiterals << " failed literals, "
+                      << stats[i].probeTime << " s" << std::endl;
+            std::cout << prefix << "vivify: " << stats[i].vivifiedClauses << " clauses, "
+                      << stats[i].vivifiedLiterals << " literals removed, " << stats[i].vivifyTime << " s" << std::endl;
+            std::cout << prefix << "substitute: " << stats[i].substitutedAtoms << " atoms, "
+                      << stats[i].substituteTime << " s" << std::endl;
+            if(stats[i].xorConstraints > 0)
+                std::cout << prefix << "xor: " << stats[i].xorConstraints << " constraints in "
+                          << stats[i].xorMatrices << " matrices, " << stats[i].xorPropagations << " propagations, "
+                          << stats[i].xorConflicts << " conflicts" << std::endl;
+            if(options.localSearch != Options::NoLocalSearch)
+                std::cout << prefix << "local search: " << stats[i].localSearches << " runs, "
+                          << stats[i].localFlips << " flips, " << stats[i].localBestUnsat << " unsat at best, "
+                          << stats[i].localTime << " s" << std::endl;
+            std::cout << prefix << "search: " << stats[i].searchTime << " s" << std::endl;
+#ifdef SAT_PROFILE
+            std::cout << prefix << "propagate: " << stats[i].propagateTime << " s" << std::endl;
+            std::cout << prefix << "analyze: " << stats[i].analyzeTime << " s" << std::endl;
+            std::cout << prefix << "reduce: " << stats[i].reduceTime << " s" << std::endl;
+#endif
+            if(stats.size() > 1) {
+                std::cout << prefix << "exported: " << stats[i].exported << std::endl;
+                std::cout << prefix << "imported: " << stats[i].imported << std::endl;
+            }
+        }
+    }
+    // Sama lokalna pretraga ne dokazuje nezadovoljivost, pa tada nema odgovora UNSAT.
+    std::string result = valuation ? "SAT" : options.localSearch == Options::LocalOnly ? "UNKNOWN" : "UNSAT";
+    if(jsonPath == "-")
+        writeJson(std::cout, result, bytes, parseTime.count(), stats);
+    else if(!jsonPath.empty()) {
+        std::ofstream out(jsonPath);
+        writeJson(out, result, bytes, parseTime.count(), stats);
+    }
+    std::cout << result << std::endl;
 
     return 0;
 }
\ No newline at end of file
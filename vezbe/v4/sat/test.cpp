@@ -0,0 +1,619 @@
+// Testovi resavaca: main.cpp se ukljucuje sa preimenovanom funkcijom main.
+// DRAT proveravac iz v4/drat se ukljucuje u prostor imena drat, jer ima
+// svoje Lit, toLit i main; standardna zaglavlja koja koristi su vec
+// ukljucena, pa se unutar prostora imena ne ukljucuju ponovo.
+// Prevodjenje: g++ -std=c++17 -O2 -pthread test.cpp -o test
+#define main solverMain
+#include "main.cpp"
+#undef main
+#include <unordered_map>
+#define main dratMain
+namespace drat {
+#include "../drat/main.cpp"
+}
+#undef main
+
+int failures = 0;
+
+void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "OK    " : "GRESKA") << " " << name << std::endl;
+    if(!condition)
+        failures++;
+}
+
+Dimacs formula(const std::string& text) {
+    Dimacs dimacs;
+    parse(text.data(), text.data() + text.size(), dimacs);
+    return dimacs;
+}
+
+std::string dimacs(const NormalForm& f, int atomCount) {
+    std::string text = "p cnf " + std::to_string(atomCount) + " " + std::to_string(f.size()) + "\n";
+    for(const Clause& clause : f) {
+        for(Literal l : clause)
+            text += std::to_string(l) + " ";
+        text += "0\n";
+    }
+    return text;
+}
+
+// Slucajna formula; klauze mogu da ponove literal ili da budu tautologije.
+NormalForm randomFormula(std::mt19937& rng, int atomCount, int clauseCount, int maxLength) {
+    NormalForm f(clauseCount);
+    for(Clause& clause : f) {
+        int length = 1 + rng() % maxLength;
+        for(int i = 0; i < length; i++)
+            clause.push_back(rng() % 2 ? 1 + rng() % atomCount : -(Literal)(1 + rng() % atomCount));
+    }
+    return f;
+}
+
+// Model je indeksiran atomom: 1 za tacan, -1 za netacan atom.
+bool satisfies(const NormalForm& f, const std::vector<signed char>& model) {
+    for(const Clause& clause : f) {
+        bool satisfied = false;
+        for(Literal l : clause)
+            satisfied = satisfied || (std::abs(l) < (int)model.size() && model[std::abs(l)] == (l > 0 ? 1 : -1));
+        if(!satisfied)
+            return false;
+    }
+    return true;
+}
+
+bool bruteForce(const NormalForm& f, int atomCount) {
+    std::vector<signed char> model(atomCount + 1);
+    for(uint32_t row = 0; row < 1u << atomCount; row++) {
+        for(int atom = 1; atom <= atomCount; atom++)
+            model[atom] = row >> (atom - 1) & 1 ? 1 : -1;
+        if(satisfies(f, model))
+            return true;
+    }
+    return false;
+}
+
+// Zbir brojaca koje testovi proveravaju, da bi se videlo da je tehnika
+// zaista radila.
+void accumulate(Statistics& total, const Statistics& s) {
+    total.conflicts += s.conflicts;
+    total.restarts += s.restarts;
+    total.reductions += s.reductions;
+    total.preprocessEliminatedAtoms += s.preprocessEliminatedAtoms;
+    total.inprocessings += s.inprocessings;
+    total.failedLiterals += s.failedLiterals;
+    total.vivifiedClauses += s.vivifiedClauses;
+    total.substitutedAtoms += s.substitutedAtoms;
+    total.xorConstraints += s.xorConstraints;
+    total.localSearches += s.localSearches;
+}
+
+// Sekvencijalni resavac sa zadatim opcijama; statistika se dodaje na total.
+auto sequential(const Options& options, Statistics* total = nullptr) {
+    return [options, total](ClauseArena formula, int atomCount) {
+        Statistics stats;
+        std::optional<PartialValuation> valuation = solve(std::move(formula), atomCount, options, &stats);
+        if(total)
+            accumulate(*total, stats);
+        return valuation;
+    };
+}
+
+// Slucajni 3-SAT sa odnosom klauza i atoma blizu faznog prelaza, gde je
+// pretraga najteza.
+NormalForm random3Sat(std::mt19937& rng, int atomCount) {
+    NormalForm f(atomCount * 426 / 100);
+    for(Clause& clause : f)
+        for(int i = 0; i < 3; i++)
+            clause.push_back(rng() % 2 ? 1 + rng() % atomCount : -(Literal)(1 + rng() % atomCount));
+    return f;
+}
+
+// Odgovor na count slucajnih formula sa do 16 atoma mora da se slaze sa
+// pretragom svih valuacija, a model (posle rekonstrukcije eliminisanih
+// atoma) mora da zadovoljava polaznu formulu. Medju formulama mora biti i
+// zadovoljivih i nezadovoljivih.
+template<typename F>
+void agreesWithBruteForce(const std::string& name, F solver, int count = 300) {
+    std::mt19937 rng(12345);
+    std::string error;
+    int satisfiable = 0;
+    for(int i = 0; i < count && error.empty(); i++) {
+        int atomCount = i % 2 ? 3 + rng() % 12 : 8 + rng() % 9;
+        NormalForm f = i % 2
+            ? randomFormula(rng, atomCount, atomCount * (2 + rng() % 4), 2 + rng() % 3)
+            : random3Sat(rng, atomCount);
+        Dimacs parsed = formula(dimacs(f, atomCount));
+        std::optional<PartialValuation> valuation = solver(std::move(parsed.formula), parsed.atomCount);
+        satisfiable += bool(valuation);
+        if(bool(valuation) != bruteForce(f, atomCount))
+            error = "odgovor, formula " + std::to_string(i);
+        else if(valuation && !satisfies(f, valuation->value))
+            error = "model, formula " + std::to_string(i);
+    }
+    if(error.empty() && (satisfiable == 0 || satisfiable == count))
+        error = "sve formule su " + std::string(satisfiable ? "SAT" : "UNSAT");
+    check(error.empty(), name + (error.empty() ? "" : ": " + error));
+}
+
+// Na vecim formulama (30 do 60 atoma, 3-SAT na faznom prelazu) odgovor se
+// poredi sa DPLL-om, a model se proverava.
+template<typename F>
+void agreesWithDpll(const std::string& name, F solver, int count = 100) {
+    std::mt19937 rng(54321);
+    Options dpll;
+    dpll.algorithm = Options::Dpll;
+    dpll.preprocess = false;
+    std::string error;
+    int satisfiable = 0;
+    for(int i = 0; i < count && error.empty(); i++) {
+        int atomCount = 30 + rng() % 31;
+        NormalForm f = random3Sat(rng, atomCount);
+        Dimacs reference = formula(dimacs(f, atomCount));
+        bool expected = bool(solve(std::move(reference.formula), reference.atomCount, dpll));
+        Dimacs parsed = formula(dimacs(f, atomCount));
+        std::optional<PartialValuation> valuation = solver(std::move(parsed.formula), parsed.atomCount);
+        satisfiable += bool(valuation);
+        if(bool(valuation) != expected)
+            error = "odgovor, formula " + std::to_string(i);
+        else if(valuation && !satisfies(f, valuation->value))
+            error = "model, formula " + std::to_string(i);
+    }
+    if(error.empty() && (satisfiable == 0 || satisfiable == count))
+        error = "sve formule su " + std::string(satisfiable ? "SAT" : "UNSAT");
+    check(error.empty(), name + (error.empty() ? "" : ": " + error));
+}
+
+void cdclBruteForce() {
+    Options dpll;
+    dpll.algorithm = Options::Dpll;
+    dpll.preprocess = false;
+    agreesWithBruteForce("DPLL prema svim valuacijama", sequential(dpll));
+    Options cdcl;
+    cdcl.preprocess = false;
+    cdcl.inprocess = false;
+    cdcl.xors = false;
+    agreesWithBruteForce("CDCL prema svim valuacijama", sequential(cdcl));
+    Options linear = cdcl;
+    linear.branching = Options::Linear;
+    linear.restarts = Options::NoRestart;
+    linear.phaseSaving = false;
+    agreesWithBruteForce("CDCL bez VSIDS-a i restarta prema svim valuacijama", sequential(linear));
+    Options luby = cdcl;
+    luby.restarts = Options::Luby;
+    luby.lubyUnit = 1;
+    luby.reduceFirst = 2;
+    luby.reduceIncrement = 1;
+    Statistics total;
+    agreesWithBruteForce("CDCL sa cestim restartima i ciscenjem baze prema svim valuacijama", sequential(luby, &total));
+    agreesWithDpll("CDCL sa cestim restartima i ciscenjem baze prema DPLL-u", sequential(luby, &total));
+    agreesWithDpll("CDCL prema DPLL-u", sequential(cdcl, &total));
+    check(total.restarts > 0 && total.reductions > 0, "CDCL: bilo je restarta i ciscenja baze");
+}
+
+// Preprocesiranje eliminise atome, a model se posle rekonstrukcije
+// proverava nad polaznom formulom.
+void preprocessBruteForce() {
+    Options options;
+    options.inprocess = false;
+    options.xors = false;
+    Statistics total;
+    agreesWithBruteForce("preprocesiranje prema svim valuacijama", sequential(options, &total));
+    agreesWithDpll("preprocesiranje prema DPLL-u", sequential(options, &total));
+    check(total.preprocessEliminatedAtoms > 0, "preprocesiranje: eliminisani su atomi");
+}
+
+// Inprocesiranje posle restarta na svakih nekoliko konflikata: probanje,
+// vivifikacija i zamena ekvivalentnih literala. Luby restarti sa malom
+// jedinicom daju restarte i na malim formulama. Posebne formule (3-SAT
+// ispod faznog prelaza) imaju ugradjene ekvivalencije, da bi zamena imala
+// sta da nadje; model posle fillSubstituted mora da zadovoljava i klauze
+// zamenjenih atoma. Odgovor se za njih poredi sa DPLL-om.
+void inprocessBruteForce() {
+    Options options;
+    options.preprocess = false;
+    options.xors = false;
+    options.restarts = Options::Luby;
+    options.lubyUnit = 4;
+    options.inprocessInterval = 10;
+    Statistics total;
+    agreesWithBruteForce("inprocesiranje prema svim valuacijama", sequential(options, &total));
+    agreesWithDpll("inprocesiranje prema DPLL-u", sequential(options, &total));
+    Options dpll;
+    dpll.algorithm = Options::Dpll;
+    dpll.preprocess = false;
+    std::mt19937 rng(2024);
+    std::string error;
+    for(int i = 0; i < 200 && error.empty(); i++) {
+        int atomCount = 30 + rng() % 31;
+        NormalForm f = random3Sat(rng, atomCount);
+        f.resize(f.size() * 7 / 10);
+        for(int j = atomCount / 5; j > 0; j--) {
+            Literal a = 1 + rng() % atomCount;
+            Literal b = rng() % 2 ? 1 + rng() % atomCount : -(Literal)(1 + rng() % atomCount);
+            f.push_back({a, -b});
+            f.push_back({-a, b});
+        }
+        Dimacs reference = formula(dimacs(f, atomCount));
+        bool expected = bool(solve(std::move(reference.formula), reference.atomCount, dpll));
+        Dimacs parsed = formula(dimacs(f, atomCount));
+        std::optional<PartialValuation> valuation = sequential(options, &total)(std::move(parsed.formula), parsed.atomCount);
+        if(bool(valuation) != expected)
+            error = "odgovor, formula " + std::to_string(i);
+        else if(valuation && !satisfies(f, valuation->value))
+            error = "model, formula " + std::to_string(i);
+    }
+    check(error.empty(), "inprocesiranje formula sa ekvivalencijama" + (error.empty() ? "" : ": " + error));
+    check(total.inprocessings > 0 && total.failedLiterals > 0 && total.vivifiedClauses > 0 && total.substitutedAtoms > 0,
+          "inprocesiranje: probanje, vivifikacija i zamena su radili");
+}
+
+// Portfolio sa vise niti koje razmenjuju naucene klauze.
+void portfolioBruteForce() {
+    for(int threads : {2, 3}) {
+        Options options;
+        options.threads = threads;
+        auto portfolio = [&](ClauseArena formula, int atomCount) {
+            return solvePortfolio(std::move(formula), atomCount, options);
+        };
+        std::string suffix = ", niti: " + std::to_string(threads);
+        agreesWithBruteForce("portfolio prema svim valuacijama" + suffix, portfolio, 100);
+        agreesWithDpll("portfolio prema DPLL-u" + suffix, portfolio, 50);
+    }
+}
+
+// Cube-and-conquer: lookahead deli formulu na kocke koje niti resavaju
+// pod pretpostavkama.
+void cubesBruteForce() {
+    for(int threads : {1, 2}) {
+        Options options;
+        options.cubes = 8;
+        options.threads = threads;
+        long long count = 0;
+        auto cubes = [&](ClauseArena formula, int atomCount) {
+            std::vector<Statistics> stats;
+            auto valuation = solveCubes(std::move(formula), atomCount, options, &stats);
+            count += stats[0].cubes;
+            return valuation;
+        };
+        std::string suffix = ", niti: " + std::to_string(threads);
+        agreesWithBruteForce("kocke prema svim valuacijama" + suffix, cubes, 100);
+        agreesWithDpll("kocke prema DPLL-u" + suffix, cubes, 50);
+        check(count > 150, "kocke: lookahead je delio formule" + suffix);
+    }
+}
+
+// Inkrementalni resavac: formula raste izmedju poziva, a svaki poziv ima
+// slucajne pretpostavke. Odgovor se poredi sa pretragom svih valuacija
+// formule sa pretpostavkama kao jedinicnim klauzama. Jezgro posle UNSAT
+// odgovora je podskup pretpostavki koji je i sam nezadovoljiv uz formulu.
+void solverCores() {
+    std::mt19937 rng(777);
+    std::string error;
+    int cores = 0, models = 0;
+    for(int i = 0; i < 200 && error.empty(); i++) {
+        int atomCount = 4 + rng() % 9;
+        Solver solver;
+        NormalForm f;
+        for(int call = 0; call < 8 && error.empty(); call++) {
+            for(const Clause& clause : randomFormula(rng, atomCount, 1 + rng() % atomCount, 3)) {
+                solver.addClause(clause);
+                f.push_back(clause);
+            }
+            std::vector<Literal> assumptions;
+            for(int j = rng() % 6; j > 0; j--)
+                assumptions.push_back(rng() % 2 ? 1 + rng() % atomCount : -(Literal)(1 + rng() % atomCount));
+            NormalForm assumed = f;
+            for(Literal l : assumptions)
+                assumed.push_back({l});
+            std::string where = ", formula " + std::to_string(i) + ", poziv " + std::to_string(call);
+            bool sat = solver.solve(assumptions);
+            if(sat != bruteForce(assumed, atomCount)) {
+                error = "odgovor" + where;
+                break;
+            }
+            if(sat) {
+                models++;
+                if(!satisfies(assumed, solver.model))
+                    error = "model" + where;
+                continue;
+            }
+            cores += !solver.core.empty();
+            NormalForm core = f;
+            for(Literal l : solver.core) {
+                core.push_back({l});
+                if(std::find(begin(assumptions), end(assumptions), l) == end(assumptions))
+                    error = "jezgro nije podskup pretpostavki" + where;
+            }
+            if(error.empty() && bruteForce(core, atomCount))
+                error = "jezgro je zadovoljivo" + where;
+        }
+    }
+    check(error.empty() && cores > 0 && models > 0, "Solver: odgovori, modeli i jezgra pretpostavki"
+          + (error.empty() ? "" : ": " + error));
+}
+
+// Klauze koje zapisuju XOR datih atoma jednak parity: zabranjena je svaka
+// dodela pogresne parnosti.
+NormalForm xorClauses(const std::vector<Literal>& atoms, bool parity) {
+    NormalForm f;
+    for(uint32_t row = 0; row < 1u << atoms.size(); row++) {
+        if((__builtin_popcount(row) % 2 == 1) == parity)
+            continue;
+        Clause clause;
+        for(size_t i = 0; i < atoms.size(); i++)
+            clause.push_back(row >> i & 1 ? -atoms[i] : atoms[i]);
+        f.push_back(clause);
+    }
+    return f;
+}
+
+// Slucajno XOR ogranicenje nad 2 do 5 razlicitih atoma.
+std::vector<Literal> randomXor(std::mt19937& rng, int atomCount) {
+    std::vector<Literal> atoms;
+    for(int size = 2 + rng() % 4; (int)atoms.size() < std::min(size, atomCount);) {
+        Literal atom = 1 + rng() % atomCount;
+        if(std::find(begin(atoms), end(atoms), atom) == end(atoms))
+            atoms.push_back(atom);
+    }
+    return atoms;
+}
+
+// XOR ogranicenja zapisana klauzama resavac nalazi i resava Gausovom
+// eliminacijom, uz slucajne klauze. Solver::addXor dodaje ogranicenja koja
+// nisu zapisana klauzama; pretraga svih valuacija ih vidi kao klauze.
+void xorBruteForce() {
+    std::mt19937 rng(31337);
+    std::string error;
+    int satisfiable = 0;
+    Statistics total;
+    for(int i = 0; i < 300 && error.empty(); i++) {
+        int atomCount = 4 + rng() % 11;
+        NormalForm f = randomFormula(rng, atomCount, atomCount * (1 + rng() % 3) / 2, 3);
+        for(int j = 1 + rng() % atomCount; j > 0; j--)
+            for(const Clause& clause : xorClauses(randomXor(rng, atomCount), rng() % 2))
+                f.push_back(clause);
+        Options options;
+        options.preprocess = i % 2;
+        Dimacs parsed = formula(dimacs(f, atomCount));
+        auto valuation = sequential(options, &total)(std::move(parsed.formula), parsed.atomCount);
+        satisfiable += bool(valuation);
+        if(bool(valuation) != bruteForce(f, atomCount))
+            error = "odgovor, formula " + std::to_string(i);
+        else if(valuation && !satisfies(f, valuation->value))
+            error = "model, formula " + std::to_string(i);
+    }
+    check(error.empty() && satisfiable > 0 && satisfiable < 300 && total.xorConstraints > 0,
+          "XOR ogranicenja u klauzama prema svim valuacijama" + (error.empty() ? "" : ": " + error));
+    error.clear();
+    satisfiable = 0;
+    int calls = 0;
+    for(int i = 0; i < 200 && error.empty(); i++) {
+        int atomCount = 4 + rng() % 9;
+        Solver solver;
+        NormalForm f;
+        for(int call = 0; call < 4 && error.empty(); call++, calls++) {
+            for(const Clause& clause : randomFormula(rng, atomCount, 1 + rng() % atomCount, 3)) {
+                solver.addClause(clause);
+                f.push_back(clause);
+            }
+            for(int j = rng() % 3; j > 0; j--) {
+                std::vector<Literal> atoms = randomXor(rng, atomCount);
+                bool parity = rng() % 2;
+                for(const Clause& clause : xorClauses(atoms, parity))
+                    f.push_back(clause);
+                // Negiran literal menja parnost.
+                Clause literals = atoms;
+                if(rng() % 2)
+                    literals[0] = -literals[0];
+                solver.addXor(literals, parity != (literals[0] < 0));
+            }
+            std::string where = ", formula " + std::to_string(i) + ", poziv " + std::to_string(call);
+            bool sat = solver.solve({});
+            satisfiable += sat;
+            if(sat != bruteForce(f, atomCount))
+                error = "odgovor" + where;
+            else if(sat && !satisfies(f, solver.model))
+                error = "model" + where;
+        }
+    }
+    check(error.empty() && satisfiable > 0 && satisfiable < calls,
+          "Solver::addXor prema svim valuacijama" + (error.empty() ? "" : ": " + error));
+}
+
+// Golubovi: holes + 1 goluba u holes rupa.
+NormalForm pigeonhole(int holes) {
+    NormalForm f;
+    auto p = [&](int i, int h) { return i * holes + h + 1; };
+    for(int i = 0; i <= holes; i++) {
+        Clause clause;
+        for(int h = 0; h < holes; h++)
+            clause.push_back(p(i, h));
+        f.push_back(clause);
+    }
+    for(int h = 0; h < holes; h++)
+        for(int i = 0; i <= holes; i++)
+            for(int j = i + 1; j <= holes; j++)
+                f.push_back({-p(i, h), -p(j, h)});
+    return f;
+}
+
+// DRAT dokaz koji resavac pise za formulu, binarni ili tekstualni.
+std::string proofOf(const NormalForm& f, int atomCount, const Options& options, bool binary, bool& sat) {
+    char path[] = "/tmp/sat-test-XXXXXX";
+    int fd = mkstemp(path);
+    {
+        ProofWriter proof(path, false, binary);
+        Dimacs parsed = formula(dimacs(f, atomCount));
+        sat = bool(solve(std::move(parsed.formula), parsed.atomCount, options, nullptr, &proof));
+    }
+    std::ifstream in(path, std::ios::binary);
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    ::close(fd);
+    unlink(path);
+    return text;
+}
+
+// Provera dokaza proveravacem iz v4/drat.
+bool verified(const NormalForm& f, int atomCount, const std::string& proof) {
+    drat::Checker checker;
+    std::string text = dimacs(f, atomCount);
+    bool parsed = drat::parseText(text.data(), text.data() + text.size(), [&](const std::vector<drat::Lit>& clause, bool) {
+        checker.addOriginal(clause);
+    });
+    auto step = [&](const std::vector<drat::Lit>& clause, bool deletion) {
+        checker.addStep(clause, deletion);
+    };
+    const char* p = proof.data();
+    parsed = parsed && (drat::isBinary(p, proof.size())
+        ? drat::parseBinary((const unsigned char*)p, (const unsigned char*)p + proof.size(), step)
+        : drat::parseText(p, p + proof.size(), step));
+    return parsed && checker.check();
+}
+
+// Nezadovoljive formule za DRAT testove: golubovi i slucajni 3-SAT od 40
+// do 80 atoma.
+std::vector<std::pair<NormalForm, int>> unsatFormulas() {
+    std::vector<std::pair<NormalForm, int>> formulas;
+    for(int holes : {3, 4, 5})
+        formulas.push_back({pigeonhole(holes), (holes + 1) * holes});
+    std::mt19937 rng(2024);
+    Options options;
+    while(formulas.size() < 40) {
+        int atomCount = 40 + rng() % 41;
+        NormalForm f = random3Sat(rng, atomCount);
+        Dimacs parsed = formula(dimacs(f, atomCount));
+        if(!solve(std::move(parsed.formula), parsed.atomCount, options))
+            formulas.push_back({f, atomCount});
+    }
+    return formulas;
+}
+
+// Dokaz koji resavac napise za nezadovoljivu formulu prolazi proveru, u
+// oba formata i sa preprocesiranjem i inprocesiranjem.
+void dratRoundTrip() {
+    std::string error;
+    for(bool binary : {true, false}) {
+        int i = 0;
+        for(const auto& [f, atomCount] : unsatFormulas()) {
+            Options options;
+            options.inprocessInterval = 50;
+            bool sat = false;
+            std::string proof = proofOf(f, atomCount, options, binary, sat);
+            if(error.empty() && (sat || !verified(f, atomCount, proof)))
+                error = std::string(binary ? "binarni" : "tekstualni") + " dokaz, formula " + std::to_string(i);
+            i++;
+        }
+    }
+    check(error.empty(), "DRAT: dokazi resavaca prolaze proveru" + (error.empty() ? "" : ": " + error));
+}
+
+// Proveravac odbija pokvarene dokaze: dokaz bez lema (samo prazna
+// klauza), dokaz odsecen usred poslednje klauze i ispravan dokaz uz
+// formulu bez klauza koje su je cinile nezadovoljivom.
+void dratRejectsCorrupted() {
+    std::mt19937 rng(99);
+    std::string error;
+    int i = 0;
+    for(const auto& [f, atomCount] : unsatFormulas()) {
+        std::string where = ", formula " + std::to_string(i++);
+        for(bool binary : {true, false}) {
+            bool sat = false;
+            std::string proof = proofOf(f, atomCount, Options(), binary, sat);
+            if(error.empty() && verified(f, atomCount, binary ? std::string("a\0", 2) : "0\n"))
+                error = "prihvacen dokaz bez lema" + where;
+            // Binarni dokaz gubi zavrsnu nulu, a tekstualni sve od nule
+            // poslednje neprazne klauze.
+            std::string cut = proof.substr(0, binary ? proof.size() - 1 : proof.rfind(" 0\n"));
+            if(error.empty() && verified(f, atomCount, cut))
+                error = "prihvacen odsecen dokaz" + where;
+            // Uklanjaju se slucajne klauze dok formula ne postane
+            // zadovoljiva; njen model potvrdjuje da jeste.
+            NormalForm weaker = f;
+            while(true) {
+                weaker.erase(begin(weaker) + rng() % weaker.size());
+                Dimacs parsed = formula(dimacs(weaker, atomCount));
+                auto valuation = solve(std::move(parsed.formula), parsed.atomCount);
+                if(valuation) {
+                    if(error.empty() && !satisfies(weaker, valuation->value))
+                        error = "model oslabljene formule" + where;
+                    break;
+                }
+            }
+            if(error.empty() && verified(weaker, atomCount, proof))
+                error = "prihvacen dokaz za zadovoljivu formulu" + where;
+        }
+    }
+    check(error.empty(), "DRAT: pokvareni dokazi se odbijaju" + (error.empty() ? "" : ": " + error));
+}
+
+// Hibridni rezim pokrece lokalnu pretragu posle restarta na svakih
+// nekoliko konflikata. U rezimu samo lokalne pretrage odgovor moze biti
+// samo SAT sa ispravnim modelom ili bez odgovora, pa nezadovoljiva formula
+// nikada ne dobija model, a zadovoljive ga uglavnom dobijaju.
+void localSearchBruteForce() {
+    Options hybrid;
+    hybrid.preprocess = false;
+    hybrid.localSearch = Options::Hybrid;
+    hybrid.localFlips = 200;
+    hybrid.localInterval = 10;
+    hybrid.restarts = Options::Luby;
+    hybrid.lubyUnit = 4;
+    Statistics total;
+    agreesWithBruteForce("hibridna lokalna pretraga prema svim valuacijama", sequential(hybrid, &total));
+    agreesWithDpll("hibridna lokalna pretraga prema DPLL-u", sequential(hybrid, &total));
+    check(total.localSearches > 0, "hibridna lokalna pretraga je pokretana");
+    Options local;
+    local.preprocess = false;
+    local.localSearch = Options::LocalOnly;
+    local.localFlips = 10000;
+    std::mt19937 rng(4242);
+    std::string error;
+    int found = 0, satisfiable = 0;
+    for(int i = 0; i < 300 && error.empty(); i++) {
+        int atomCount = 8 + rng() % 9;
+        NormalForm f = random3Sat(rng, atomCount);
+        Dimacs parsed = formula(dimacs(f, atomCount));
+        auto valuation = solve(std::move(parsed.formula), parsed.atomCount, local);
+        bool expected = bruteForce(f, atomCount);
+        satisfiable += expected;
+        found += bool(valuation);
+        if(valuation && !expected)
+            error = "model nezadovoljive formule " + std::to_string(i);
+        else if(valuation && !satisfies(f, valuation->value))
+            error = "model, formula " + std::to_string(i);
+    }
+    check(error.empty() && found > satisfiable / 2, "samo lokalna pretraga: modeli su ispravni"
+          + (error.empty() ? "" : ": " + error));
+}
+
+// Tri goluba u dve rupe: nezadovoljivo, pa lokalna pretraga ne nalazi model.
+const char* pigeons =
+    "p cnf 6 9\n"
+    "1 2 0\n3 4 0\n5 6 0\n"
+    "-1 -3 0\n-1 -5 0\n-3 -5 0\n"
+    "-2 -4 0\n-2 -6 0\n-4 -6 0\n";
+
+void localOnlyPortfolio() {
+    Options options;
+    options.localSearch = Options::LocalOnly;
+    options.localFlips = 10000;
+    options.threads = 2;
+    options.preprocess = false;
+    Dimacs dimacs = formula(pigeons);
+    auto valuation = solvePortfolio(std::move(dimacs.formula), dimacs.atomCount, options);
+    check(!valuation, "portfolio sa samo lokalnom pretragom bez pobednika");
+}
+
+int main() {
+    cdclBruteForce();
+    preprocessBruteForce();
+    inprocessBruteForce();
+    portfolioBruteForce();
+    cubesBruteForce();
+    solverCores();
+    xorBruteForce();
+    dratRoundTrip();
+    dratRejectsCorrupted();
+    localSearchBruteForce();
+    localOnlyPortfolio();
+    return failures > 0;
+}
@@ -1,7 +1,13 @@
 #include <iostream>
 #include <variant>
 #include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
 #include <set>
+#include <algorithm>
 #include <vector>
 
 struct False;
@@ -13,14 +19,15 @@ struct Literal;
 
 using Formula = std::variant<False, True, Atom, Not, Binary>;
 using FormulaPtr = std::shared_ptr<Formula>;
-using Valuation = std::map<std::string, bool>;
-using AtomSet = std::set<std::string>;
+using AtomId = uint32_t;
+using Valuation = std::map<AtomId, bool>;
+using AtomSet = std::set<AtomId>;
 using Clause = std::vector<Literal>;
 using NormalForm = std::vector<Clause>;
 
 struct False {};
 struct True {};
-struct Atom { std::string name; };
+struct Atom { AtomId id; };
 struct Not { FormulaPtr subformula; };
 struct Binary {
    enum Type { And, Or, Impl, Eq } type;
@@ -28,9 +35,50 @@ struct Binary {
 };
 struct Literal {
     bool pos;
-    std::string name;
+    AtomId atom;
 };
 
+// Tabela simbola: svako ime atoma se cuva jednom, a formule, literali,
+// valuacije i klauze koriste gust 32-bitni identifikator (0, 1, 2, ... po
+// redu prvog pojavljivanja). Ime se trazi samo pri ucitavanju i ispisu, pa
+// je identifikator + 1 direktno DIMACS promenljiva.
+struct SymbolTable {
+   std::vector<std::string> names;
+   std::unordered_map<std::string, AtomId> ids;
+};
+
+SymbolTable& symbols() {
+   static SymbolTable table;
+   return table;
+}
+
+AtomId intern(const std::string& name) {
+   SymbolTable& table = symbols();
+   auto [it, inserted] = table.ids.emplace(name, table.names.size());
+   if(inserted)
+      table.names.push_back(name);
+   return it->second;
+}
+
+const std::string& atomName(AtomId atom) {
+   return symbols().names[atom];
+}
+
+// Novi atom, npr. Tseitinova promenljiva podformule. Za ispis dobija prvo
+// od imena "s1", "s2", ... koje jos nije zauzeto, ali se ime ne upisuje u
+// ids, pa ga intern nikad ne vraca: atom istog imena ucitan kasnije je
+// drugi atom.
+AtomId fresh() {
+   static unsigned count = 0;
+   SymbolTable& table = symbols();
+   std::string name;
+   do
+      name = "s" + std::to_string(++count);
+   while(table.ids.count(name));
+   table.names.push_back(name);
+   return table.names.size() - 1;
+}
+
 FormulaPtr ptr(Formula f) { return std::make_shared<Formula>(f); }
 
 template <typename T>
@@ -61,7 +109,7 @@ int complexity(const FormulaPtr& f) {
 std::string print(const FormulaPtr& f) {
    if(is<False>(f)) return "F";
    if(is<True>(f)) return "T";
-   if(is<Atom>(f)) return as<Atom>(f).name;
+   if(is<Atom>(f)) return atomName(as<Atom>(f).id);
    if(is<Not>(f)) return "~" + print(as<Not>(f).subformula);
    if(is<Binary>(f)) {
       std::string sign;
@@ -82,7 +130,7 @@ bool evaluate(const FormulaPtr& f, Valuation& v) {
    if(is<True>(f))
       return true;
    if(is<Atom>(f))
-      return v[as<Atom>(f).name];
+      return v[as<Atom>(f).id];
    if(is<Not>(f))
       return !evaluate(as<Not>(f).subformula, v);
    if(is<Binary>(f)) {
@@ -107,7 +155,7 @@ bool equal(const FormulaPtr& f, const FormulaPtr& g) {
       return true;
 
    if(is<Atom>(f))
-      return as<Atom>(f).name == as<Atom>(g).name;
+      return as<Atom>(f).id == as<Atom>(g).id;
 
    if(is<Not>(f))
       return equal(as<Not>(f).subformula, as<Not>(g).subformula);
@@ -139,7 +187,7 @@ FormulaPtr substitute(const FormulaPtr& f, const FormulaPtr& what, const Formula
 
 void getAtoms(const FormulaPtr& f, AtomSet& atoms) {
     if(is<Atom>(f))
-        atoms.insert(as<Atom>(f).name);
+        atoms.insert(as<Atom>(f).id);
     else if(is<Not>(f))
         getAtoms(as<Not>(f).subformula, atoms);
     else if(is<Binary>(f)) {
@@ -162,31 +210,55 @@ bool next(Valuation& v) {
     return it->second = true;
 }
 
+// Atomi formule po imenu. Identifikatori prate redosled ucitavanja, a
+// kolone tablice i redosled valuacija su po abecedi.
+std::vector<AtomId> atomsByName(const FormulaPtr& f) {
+    AtomSet atoms;
+    getAtoms(f, atoms);
+    std::vector<AtomId> sorted(begin(atoms), end(atoms));
+    std::sort(begin(sorted), end(sorted), [](AtomId a, AtomId b) { return atomName(a) < atomName(b); });
+    return sorted;
+}
+
+// Sledeca valuacija kada je prvi atom iz atoms najnizi bit.
+bool next(Valuation& v, const std::vector<AtomId>& atoms) {
+    auto it = begin(atoms);
+
+    while(it != end(atoms) && v[*it]) {
+        v[*it] = false;
+        it++;
+    }
+
+    if(it == end(atoms))
+        return false;
+
+    return v[*it] = true;
+}
+
 void print(Valuation& v) {
     for(const auto& [atom, value] : v)
         std::cout << value << ' ';
 }
 
 void table(const FormulaPtr& f) {
-    AtomSet atoms;
-    getAtoms(f, atoms);
+    std::vector<AtomId> atoms = atomsByName(f);
 
     Valuation v;
-    for(const std::string& atom : atoms) {
+    for(AtomId atom : atoms) {
         v[atom] = false;
-        std::cout << atom << ' ';
+        std::cout << atomName(atom) << ' ';
     }
     std::cout << std::endl;
 
     do {
-        print(v);
+        for(AtomId atom : atoms)
+            std::cout << v[atom] << ' ';
         std::cout << "| " << evaluate(f, v) << std::endl;
-    } while(next(v));
+    } while(next(v, atoms));
 }
 
 std::optional<Valuation> isSatisfiable(const FormulaPtr& f) {
-    AtomSet atoms;
-    getAtoms(f, atoms);
+    std::vector<AtomId> atoms = atomsByName(f);
 
     Valuation v;
     for(const auto& atom : atoms)
@@ -195,7 +267,7 @@ std::optional<Valuation> isSatisfiable(const FormulaPtr& f) {
     do {
         if(evaluate(f, v))
             return v;
-    } while(next(v));
+    } while(next(v, atoms));
     return {};
 }
 
@@ -278,6 +350,7 @@ FormulaPtr nnfNot(const FormulaPtr& f) {
             ptr(Binary{Binary::And, nnf(b.left), nnfNot(b.right)}),
             ptr(Binary{Binary::And, nnfNot(b.left), nnf(b.right)})
         });
+    return FormulaPtr{};
 }
 
 FormulaPtr nnf(const FormulaPtr& f) {
@@ -322,9 +395,9 @@ NormalForm cnf(const FormulaPtr& f) {
     if(is<False>(f))
         return {{}};
     if(is<Atom>(f))
-        return {{Literal{true, as<Atom>(f).name}}};
+        return {{Literal{true, as<Atom>(f).id}}};
     if(is<Not>(f))
-        return {{Literal{false, as<Atom>(as<Not>(f).subformula).name}}};
+        return {{Literal{false, as<Atom>(as<Not>(f).subformula).id}}};
     auto b = as<Binary>(f);
     if(b.type == Binary::And)
         return concat(cnf(b.left), cnf(b.right));
@@ -339,9 +412,9 @@ NormalForm dnf(const FormulaPtr& nnf) {
     else if(is<True>(nnf))
         return {};
     else if(is<Atom>(nnf))
-        return {{Literal{true, as<Atom>(nnf).name}}};
+        return {{Literal{true, as<Atom>(nnf).id}}};
     else if(is<Not>(nnf)) // since the formula is in NNF, only Atom's can be negated
-        return {{Literal{false, as<Atom>(as<Not>(nnf).subformula).name}}};
+        return {{Literal{false, as<Atom>(as<Not>(nnf).subformula).id}}};
     else { // is<Binary>(nnf)
         const auto [type, left, right] = as<Binary>(nnf);
         if (type == Binary::And) {
@@ -352,23 +425,23 @@ NormalForm dnf(const FormulaPtr& nnf) {
     }
 }
 
-std::string tseitinRec(const FormulaPtr& f, int& subCount, NormalForm& cnf) {
+AtomId tseitinRec(const FormulaPtr& f, NormalForm& cnf) {
     if(is<False>(f)) {
-        std::string sub = "s" + std::to_string(++subCount);
+        AtomId sub = fresh();
         cnf.push_back({Literal{false, sub}});
         return sub;
     }
     else if(is<True>(f)) {
-        std::string sub = "s" + std::to_string(++subCount);
+        AtomId sub = fresh();
         cnf.push_back({Literal{true, sub}});
         return sub;
     }
     else if(is<Atom>(f)) {
-        return as<Atom>(f).name;
+        return as<Atom>(f).id;
     }
     else if(is<Not>(f)) {
-        std::string subformula = tseitinRec(as<Not>(f).subformula, subCount, cnf);
-        std::string sub = "s" + std::to_string(++subCount);
+        AtomId subformula = tseitinRec(as<Not>(f).subformula, cnf);
+        AtomId sub = fresh();
         cnf.push_back({
                 Literal{false, subformula},
                 Literal{false, sub}
@@ -381,9 +454,9 @@ std::string tseitinRec(const FormulaPtr& f, int& subCount, NormalForm& cnf) {
     }
     else { // is<Binary>(f)
         Binary b = as<Binary>(f);
-        std::string l = tseitinRec(b.left, subCount, cnf);
-        std::string r = tseitinRec(b.right, subCount, cnf);
-        std::string sub = "s" + std::to_string(++subCount);
+        AtomId l = tseitinRec(b.left, cnf);
+        AtomId r = tseitinRec(b.right, cnf);
+        AtomId sub = fresh();
         if(b.type == Binary::And) { // s <=> (p & q) == ~s || p
             cnf.push_back({
                 Literal{false, sub},
@@ -458,8 +531,7 @@ std::string tseitinRec(const FormulaPtr& f, int& subCount, NormalForm& cnf) {
 
 NormalForm tseitin(const FormulaPtr& f) {
     NormalForm cnf;
-    int subCount = 0;
-    std::string sub = tseitinRec(f, subCount, cnf);
+    AtomId sub = tseitinRec(f, cnf);
     cnf.push_back({Literal{true, sub}});
     return cnf;
 }
@@ -468,12 +540,27 @@ void print(const NormalForm& f) {
     for(const auto& clause : f) {
         std::cout << "[ ";
         for (const auto &literal: clause)
-            std::cout << (literal.pos ? "" : "~") << literal.name << " ";
+            std::cout << (literal.pos ? "" : "~") << atomName(literal.atom) << " ";
         std::cout << "]";
     }
     std::cout << std::endl;
 }
 
+// DIMACS zapis: atom sa identifikatorom i je promenljiva i + 1.
+void printDimacs(const NormalForm& f) {
+    AtomId atoms = 0;
+    for(const auto& clause : f)
+        for(const auto& literal : clause)
+            atoms = std::max(atoms, literal.atom + 1);
+    std::cout << "p cnf " << atoms << " " << f.size() << "\n";
+    for(const auto& clause : f) {
+        for(const auto& literal : clause)
+            std::cout << (literal.pos ? "" : "-") << literal.atom + 1 << " ";
+        std::cout << "0\n";
+    }
+    std::cout.flush();
+}
+
 int main() {
    return 0;
 }
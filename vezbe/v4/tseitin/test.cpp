@@ -0,0 +1,67 @@
+// Testovi: main.cpp se ukljucuje sa preimenovanom funkcijom main.
+// Prevodjenje: g++ -std=c++17 -O2 test.cpp -o test
+#define main tseitinMain
+#include "main.cpp"
+#undef main
+#include <sstream>
+
+int failures = 0;
+
+void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "OK    " : "GRESKA") << " " << name << std::endl;
+    if(!condition)
+        failures++;
+}
+
+template<typename F>
+std::string captured(F f) {
+    std::ostringstream out;
+    std::streambuf* old = std::cout.rdbuf(out.rdbuf());
+    f();
+    std::cout.rdbuf(old);
+    return out.str();
+}
+
+// Kolone i vrste tablice su po imenu atoma, kao pre uvodjenja
+// identifikatora, iako su atomi ucitani obrnutim redom.
+void tableOrder() {
+    FormulaPtr r = ptr(Atom{intern("r")});
+    FormulaPtr q = ptr(Atom{intern("q")});
+    FormulaPtr p = ptr(Atom{intern("p")});
+    FormulaPtr f = ptr(Binary{Binary::Impl, ptr(Binary{Binary::And, r, q}), ptr(Not{p})});
+    std::string expected =
+        "p q r \n"
+        "0 0 0 | 1\n"
+        "1 0 0 | 1\n"
+        "0 1 0 | 1\n"
+        "1 1 0 | 1\n"
+        "0 0 1 | 1\n"
+        "1 0 1 | 1\n"
+        "0 1 1 | 1\n"
+        "1 1 1 | 0\n";
+    check(captured([&] { table(f); }) == expected, "table: kolone i vrste po imenu");
+}
+
+// Tseitinova promenljiva se ne spaja sa kasnije ucitanim atomom istog imena.
+void freshIsAnonymous() {
+    FormulaPtr a = ptr(Atom{intern("a")});
+    FormulaPtr b = ptr(Atom{intern("b")});
+    NormalForm cnf = tseitin(ptr(Binary{Binary::Or, a, ptr(Not{b})}));
+    AtomSet atoms;
+    for(const Clause& clause : cnf)
+        for(const Literal& literal : clause)
+            atoms.insert(literal.atom);
+    AtomId s1 = intern("s1");
+    bool named = false;
+    for(AtomId atom : atoms)
+        named = named || atomName(atom) == "s1";
+    check(named, "fresh: Tseitinova promenljiva s1");
+    check(!atoms.count(s1), "fresh: intern(\"s1\") je novi atom");
+    check(intern("s1") == s1 && atomName(s1) == "s1", "intern: ponovo isti atom");
+}
+
+int main() {
+    tableOrder();
+    freshIsAnonymous();
+    return failures > 0;
+}
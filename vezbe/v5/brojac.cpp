@@ -1,19 +1,12 @@
 #include<iostream>
 #include<vector>
-
-using Literal = int;
-using Clause = std::vector<Literal>;
-using NormalForm = std::vector<Clause>;
-
-int varCount = 0;
-NormalForm cnf;
+#include "kardinalnost.h"
 
 int p(int i);
 int q(int i);
-void R(int i, int j);
-void nJ(int i, int j);
-void clause(const Clause &c);
-void printDimacs();
+template<typename Sink> void R(Sink& sink, int i, int j);
+template<typename Sink> void nJ(Sink& sink, int i, int j);
+template<typename Sink> void counter(Sink& sink);
 
 int p(int i) {
     return 2*i+1;
@@ -23,44 +16,39 @@ int q(int i) {
     return 2*i+2;
 }
 
-void R(int i, int j) {
-    clause({p(i), q(i), -p(i+1)});
-    clause({p(i), -q(i), p(i+1)});
-    clause({-p(i), q(i), p(i+1)});
-    clause({-p(i), -q(i), -p(i+1)});
-    clause({q(i), q(i+1)});
-    clause({-q(i), -q(i+1)});
-}
-
-void nJ(int i, int j) {
-    clause({p(i), p(j), q(i), q(j)});
-    clause({-p(i), -p(j), q(i), q(j)});
-    clause({p(i), p(j), -q(i), -q(j)});
-    clause({-p(i), -p(j), -q(i), -q(j)});
+template<typename Sink>
+void R(Sink& sink, int i, int j) {
+    sink.addClause({p(i), q(i), -p(i+1)});
+    sink.addClause({p(i), -q(i), p(i+1)});
+    sink.addClause({-p(i), q(i), p(i+1)});
+    sink.addClause({-p(i), -q(i), -p(i+1)});
+    sink.addClause({q(i), q(i+1)});
+    sink.addClause({-q(i), -q(i+1)});
 }
 
-void clause(const Clause& c) {
-    cnf.push_back(c);
-    for(auto& literal : c)
-        varCount = std::max(varCount, std::abs(literal));
+template<typename Sink>
+void nJ(Sink& sink, int i, int j) {
+    sink.addClause({p(i), p(j), q(i), q(j)});
+    sink.addClause({-p(i), -p(j), q(i), q(j)});
+    sink.addClause({p(i), p(j), -q(i), -q(j)});
+    sink.addClause({-p(i), -p(j), -q(i), -q(j)});
 }
 
-void printDimacs() {
-    std::cout << "p cnf " << varCount << " " << cnf.size() << std::endl;
-    for(auto& clause : cnf) {
-        for(auto& literal : clause) {
-            std::cout << literal << " ";
-        }
-        std::cout << "0" << std::endl;
-    }
+template<typename Sink>
+void counter(Sink& sink) {
+    R(sink, 0, 1);
+    R(sink, 1, 2);
+    R(sink, 2, 3);
+    R(sink, 3, 4);
+    nJ(sink, 0, 4);
 }
 
+// Formula se pravi dva puta: prvi put se samo prebroje atomi i klauze za
+// DIMACS zaglavlje, a drugi put se klauze pisu direktno na izlaz, bez
+// cuvanja cele formule u memoriji.
 int main() {
-    R(0, 1);
-    R(1, 2);
-    R(2, 3);
-    R(3, 4);
-    nJ(0, 4);
-
-    printDimacs();
-}
\ No newline at end of file
+    CountingSink count;
+    counter(count);
+    DimacsSink dimacs(std::cout, count.atomCount, count.clauseCount);
+    counter(dimacs);
+}
@@ -0,0 +1,366 @@
+#ifndef KARDINALNOST_H
+#define KARDINALNOST_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <charconv>
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <cstdlib>
+
+using Literal = int;
+using Clause = std::vector<Literal>;
+
+// Velicina kodiranja: broj novih (pomocnih) atoma i broj klauza.
+struct EncodingSize {
+    long long atoms = 0;
+    long long clauses = 0;
+};
+
+// Odrediste koje klauze samo broji i pamti najveci atom, npr. za prvi
+// prolaz pre pisanja DIMACS zaglavlja.
+struct CountingSink {
+    int atomCount = 0;
+    long long clauseCount = 0;
+
+    void addClause(const Clause& clause) {
+        for(Literal l : clause)
+            atomCount = std::max(atomCount, std::abs(l));
+        clauseCount++;
+    }
+};
+
+// DIMACS koji se pise u tok dok se klauze dodaju. Zaglavlje ide prvo, pa
+// broj atoma i klauza mora biti poznat unapred (npr. iz CountingSink-a).
+// Klauze se skupljaju u bafer koji se upisuje kada se napuni.
+struct DimacsSink {
+    std::ostream& out;
+    std::string buffer;
+
+    DimacsSink(std::ostream& out, int atomCount, long long clauseCount) : out(out) {
+        out << "p cnf " << atomCount << " " << clauseCount << "\n";
+    }
+
+    ~DimacsSink() {
+        flush();
+    }
+
+    void addClause(const Clause& clause) {
+        char number[16];
+        for(Literal l : clause) {
+            buffer.append(number, std::to_chars(number, number + sizeof number, l).ptr);
+            buffer += ' ';
+        }
+        buffer += "0\n";
+        if(buffer.size() >= 1 << 20)
+            flush();
+    }
+
+    void flush() {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+        out.flush();
+    }
+};
+
+// Kodiranja ogranicenja "najvise k od zadatih literala je tacno" u KNF.
+// Ogranicenje "najmanje k" je "najvise n - k" nad negacijama, a "tacno k"
+// je oba. Sink je bilo sta sa addClause(const Clause&): CountingSink,
+// DimacsSink ili Solver iz v4/sat. Novi atomi se uzimaju redom posle
+// atomCount, koji se pri tome povecava.
+//
+// - Pairwise: sve (k+1)-torke literala, bez novih atoma, C(n, k+1) klauza.
+// - SequentialCounter (Sinz): brojac do k posle svakog literala,
+//   (n-1)k atoma i 2nk + n - 3k - 1 klauza.
+// - Totalizer (Bailleux, Boufkhad): binarno stablo koje u unarnom zapisu
+//   sabira do k+1, O(n log n) atoma i O(nk) klauza.
+// - CardinalityNetwork (Asin i dr.): mreza za sortiranje po k+1 (k+1
+//   zaokruzeno na stepen dvojke), O(n log^2 k) atoma i klauza.
+//
+// Sva kodiranja sadrze samo klauze u smeru "ako je bar i ulaza tacno, i-ti
+// izlaz je tacan", sto je dovoljno za gornju granicu.
+struct CardinalityEncoding {
+    enum Encoding { Auto, Pairwise, SequentialCounter, Totalizer, CardinalityNetwork };
+
+    static EncodingSize sequentialCounterSize(long long n, long long k) {
+        return {(n - 1) * k, 2 * n * k + n - 3 * k - 1};
+    }
+
+    // Velicina totalizatora nad m literala sa izlazima do k+1.
+    static EncodingSize totalizerSize(int m, int k) {
+        EncodingSize s = totalizerNode(m, k).second;
+        s.clauses++;
+        return s;
+    }
+
+    // C(n, r), ili limit ako je veci od njega.
+    static long long binomial(long long n, long long r, long long limit) {
+        // C(n, r) = C(n, n-r); za r > n/2 bi medjuvrednosti prerano presle limit.
+        r = std::min(r, n - r);
+        long long c = 1;
+        for(long long i = 0; i < r; i++) {
+            c = c * (n - i) / (i + 1);
+            if(c > limit)
+                return limit;
+        }
+        return c;
+    }
+
+    static Encoding choose(int n, int k);
+
+private:
+    // Broj izlaza i velicina totalizatora nad m literala, istim podelama
+    // kao totalizer().
+    static std::pair<long long, EncodingSize> totalizerNode(long long m, long long k) {
+        if(m == 1)
+            return {1, {}};
+        auto [p, left] = totalizerNode(m / 2, k);
+        auto [q, right] = totalizerNode(m - m / 2, k);
+        long long out = std::min(p + q, k + 1);
+        EncodingSize s{left.atoms + right.atoms + out, left.clauses + right.clauses};
+        // Parovi 0 <= i <= p, 0 <= j <= q sa 1 <= i + j <= out.
+        for(long long i = 0; i <= p; i++)
+            s.clauses += std::max(0LL, std::min(q, out - i) - std::max(0LL, 1 - i) + 1);
+        return {out, s};
+    }
+};
+
+template<typename Sink>
+struct Cardinality : CardinalityEncoding {
+    Sink& sink;
+    int& atomCount;
+    // Ukupna velicina svega sto je ovaj koder napisao.
+    EncodingSize size;
+
+    Cardinality(Sink& sink, int& atomCount) : sink(sink), atomCount(atomCount) {}
+
+    EncodingSize atMost(const std::vector<Literal>& lits, int k, Encoding encoding = Auto) {
+        EncodingSize before = size;
+        int n = lits.size();
+        if(k < 0)
+            emit({});
+        else if(k == 0) {
+            for(Literal l : lits)
+                emit({-l});
+        }
+        else if(k < n) {
+            if(encoding == Auto)
+                encoding = choose(n, k);
+            switch(encoding) {
+                case Auto:
+                case Pairwise: pairwise(lits, k); break;
+                case SequentialCounter: sequentialCounter(lits, k); break;
+                case Totalizer: emit({-totalizer(lits, 0, n, k)[k]}); break;
+                case CardinalityNetwork: cardinalityNetwork(lits, k); break;
+            }
+        }
+        return {size.atoms - before.atoms, size.clauses - before.clauses};
+    }
+
+    EncodingSize atLeast(const std::vector<Literal>& lits, int k, Encoding encoding = Auto) {
+        std::vector<Literal> negated;
+        for(Literal l : lits)
+            negated.push_back(-l);
+        return atMost(negated, lits.size() - k, encoding);
+    }
+
+    EncodingSize exactly(const std::vector<Literal>& lits, int k, Encoding encoding = Auto) {
+        EncodingSize upper = atMost(lits, k, encoding);
+        EncodingSize lower = atLeast(lits, k, encoding);
+        return {upper.atoms + lower.atoms, upper.clauses + lower.clauses};
+    }
+
+private:
+    int newAtom() {
+        size.atoms++;
+        return ++atomCount;
+    }
+
+    void emit(const Clause& clause) {
+        size.clauses++;
+        sink.addClause(clause);
+    }
+
+    void pairwise(const std::vector<Literal>& lits, int k) {
+        int n = lits.size();
+        std::vector<int> index(k + 1);
+        for(int i = 0; i <= k; i++)
+            index[i] = i;
+        Clause clause(k + 1);
+        while(true) {
+            for(int i = 0; i <= k; i++)
+                clause[i] = -lits[index[i]];
+            emit(clause);
+            int i = k;
+            while(i >= 0 && index[i] == n - k - 1 + i)
+                i--;
+            if(i < 0)
+                break;
+            index[i]++;
+            for(int j = i + 1; j <= k; j++)
+                index[j] = index[j - 1] + 1;
+        }
+    }
+
+    // s[i][j] znaci da je bar j+1 od literala 0..i tacno.
+    void sequentialCounter(const std::vector<Literal>& lits, int k) {
+        int n = lits.size();
+        std::vector<std::vector<Literal>> s(n - 1, std::vector<Literal>(k));
+        for(auto& row : s)
+            for(Literal& atom : row)
+                atom = newAtom();
+        emit({-lits[0], s[0][0]});
+        for(int j = 1; j < k; j++)
+            emit({-s[0][j]});
+        for(int i = 1; i < n - 1; i++) {
+            emit({-lits[i], s[i][0]});
+            emit({-s[i - 1][0], s[i][0]});
+            for(int j = 1; j < k; j++) {
+                emit({-lits[i], -s[i - 1][j - 1], s[i][j]});
+                emit({-s[i - 1][j], s[i][j]});
+            }
+            emit({-lits[i], -s[i - 1][k - 1]});
+        }
+        emit({-lits[n - 1], -s[n - 2][k - 1]});
+    }
+
+    // Izlazi cvora nad literalima lo..hi-1: i-ti izlaz je tacan ako je bar
+    // i+1 literala tacno, najvise do k+1.
+    std::vector<Literal> totalizer(const std::vector<Literal>& lits, int lo, int hi, int k) {
+        if(hi - lo == 1)
+            return {lits[lo]};
+        int mid = lo + (hi - lo) / 2;
+        std::vector<Literal> a = totalizer(lits, lo, mid, k);
+        std::vector<Literal> b = totalizer(lits, mid, hi, k);
+        std::vector<Literal> out(std::min<size_t>(a.size() + b.size(), k + 1));
+        for(Literal& atom : out)
+            atom = newAtom();
+        for(size_t i = 0; i <= a.size(); i++) {
+            for(size_t j = 0; j <= b.size(); j++) {
+                size_t sum = i + j;
+                if(sum == 0 || sum > out.size())
+                    continue;
+                Clause clause;
+                if(i > 0)
+                    clause.push_back(-a[i - 1]);
+                if(j > 0)
+                    clause.push_back(-b[j - 1]);
+                clause.push_back(out[sum - 1]);
+                emit(clause);
+            }
+        }
+        return out;
+    }
+
+    // Mreze rade nad nizovima opadajuce sortiranim po istinitosti, a 0 je
+    // konstanta netacno, pa komparator sa njom nista ne kodira.
+    std::pair<Literal, Literal> comparator(Literal a, Literal b) {
+        if(a == 0)
+            return {b, 0};
+        if(b == 0)
+            return {a, 0};
+        Literal high = newAtom(), low = newAtom();
+        emit({-a, high});
+        emit({-b, high});
+        emit({-a, -b, low});
+        return {high, low};
+    }
+
+    static std::vector<Literal> part(const std::vector<Literal>& a, size_t first) {
+        std::vector<Literal> result;
+        for(size_t i = first; i < a.size(); i += 2)
+            result.push_back(a[i]);
+        return result;
+    }
+
+    // Spaja dva sortirana niza iste duzine (stepen dvojke).
+    std::vector<Literal> merge(const std::vector<Literal>& a, const std::vector<Literal>& b) {
+        size_t n = a.size();
+        if(n == 1) {
+            auto [high, low] = comparator(a[0], b[0]);
+            return {high, low};
+        }
+        std::vector<Literal> d = merge(part(a, 0), part(b, 0));
+        std::vector<Literal> e = merge(part(a, 1), part(b, 1));
+        std::vector<Literal> c(2 * n);
+        c[0] = d[0];
+        for(size_t i = 1; i < n; i++)
+            std::tie(c[2 * i - 1], c[2 * i]) = comparator(d[i], e[i - 1]);
+        c[2 * n - 1] = e[n - 1];
+        return c;
+    }
+
+    std::vector<Literal> sort(const std::vector<Literal>& a) {
+        if(a.size() == 1)
+            return a;
+        std::vector<Literal> left(a.begin(), a.begin() + a.size() / 2);
+        std::vector<Literal> right(a.begin() + a.size() / 2, a.end());
+        return merge(sort(left), sort(right));
+    }
+
+    // Spajanje koje daje samo prvih n+1 izlaza.
+    std::vector<Literal> simplifiedMerge(const std::vector<Literal>& a, const std::vector<Literal>& b) {
+        size_t n = a.size();
+        if(n == 1) {
+            auto [high, low] = comparator(a[0], b[0]);
+            return {high, low};
+        }
+        std::vector<Literal> d = simplifiedMerge(part(a, 0), part(b, 0));
+        std::vector<Literal> e = simplifiedMerge(part(a, 1), part(b, 1));
+        std::vector<Literal> c(n + 1);
+        c[0] = d[0];
+        for(size_t i = 1; i <= n / 2; i++)
+            std::tie(c[2 * i - 1], c[2 * i]) = comparator(d[i], e[i - 1]);
+        return c;
+    }
+
+    // Prvih m sortiranih izlaza za ulaze ciji je broj umnozak od m.
+    std::vector<Literal> card(const std::vector<Literal>& a, size_t m) {
+        if(a.size() == m)
+            return sort(a);
+        std::vector<Literal> first(a.begin(), a.begin() + m);
+        std::vector<Literal> rest(a.begin() + m, a.end());
+        std::vector<Literal> c = simplifiedMerge(card(first, m), card(rest, m));
+        c.resize(m);
+        return c;
+    }
+
+    void cardinalityNetwork(const std::vector<Literal>& lits, int k) {
+        size_t m = 1;
+        while(m < (size_t)k + 1)
+            m *= 2;
+        std::vector<Literal> a = lits;
+        a.resize((a.size() + m - 1) / m * m, 0);
+        Literal overflow = card(a, m)[k];
+        if(overflow != 0)
+            emit({-overflow});
+    }
+};
+
+// Kodiranje sa najmanje klauza za n literala i granicu 0 < k < n, a
+// medju jednakima ono sa manje novih atoma. Velicina brojaca i
+// totalizatora se racuna, a mreza se gradi naprazno, sto je jeftino jer
+// je ona obicno najmanja.
+inline CardinalityEncoding::Encoding CardinalityEncoding::choose(int n, int k) {
+    Encoding best = SequentialCounter;
+    EncodingSize bestSize = sequentialCounterSize(n, k);
+    auto consider = [&](Encoding encoding, EncodingSize s) {
+        if(s.clauses < bestSize.clauses || (s.clauses == bestSize.clauses && s.atoms < bestSize.atoms)) {
+            best = encoding;
+            bestSize = s;
+        }
+    };
+    consider(Totalizer, totalizerSize(n, k));
+    CountingSink counting;
+    int atoms = n;
+    std::vector<Literal> lits(n);
+    for(int i = 0; i < n; i++)
+        lits[i] = i + 1;
+    consider(CardinalityNetwork, Cardinality<CountingSink>(counting, atoms).atMost(lits, k, CardinalityNetwork));
+    consider(Pairwise, {0, binomial(n, k + 1, bestSize.clauses + 1)});
+    return best;
+}
+
+#endif
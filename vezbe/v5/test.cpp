@@ -0,0 +1,183 @@
+// Testovi kodiranja kardinalnosti.
+// Prevodjenje: g++ -std=c++17 -O2 test.cpp -o test
+#include<iostream>
+#include<climits>
+#include "kardinalnost.h"
+
+int failures = 0;
+
+void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "OK    " : "GRESKA") << " " << name << std::endl;
+    if(!condition)
+        failures++;
+}
+
+// Za k = n-1 dovoljna je jedna klauza (nisu svi literali tacni), pa
+// izbor mora pasti na Pairwise.
+void closeToN() {
+    check(CardinalityEncoding::binomial(10, 10, 1000) == 1, "C(10, 10) = 1");
+    check(CardinalityEncoding::binomial(100, 99, 1000) == 100, "C(100, 99) = 100");
+    check(CardinalityEncoding::binomial(100, 98, 1000) == 1000, "C(100, 98) > 1000");
+    for(int n : {10, 100}) {
+        std::string name = "n = " + std::to_string(n) + ", k = n-1";
+        check(CardinalityEncoding::choose(n, n - 1) == CardinalityEncoding::Pairwise, name + ": Pairwise");
+        CountingSink counting;
+        int atoms = n;
+        std::vector<Literal> lits(n);
+        for(int i = 0; i < n; i++)
+            lits[i] = i + 1;
+        EncodingSize s = Cardinality<CountingSink>(counting, atoms).atMost(lits, n - 1);
+        check(s.clauses == 1 && s.atoms == 0, name + ": jedna klauza");
+    }
+}
+
+// Odrediste koje pamti klauze.
+struct RecordingSink {
+    std::vector<Clause> clauses;
+    void addClause(const Clause& clause) { clauses.push_back(clause); }
+};
+
+// DPLL sa propagacijom jedinicnih klauza; values[a] je 1, -1 ili 0
+// (nedodeljen) za atom a.
+bool satisfiable(const std::vector<Clause>& clauses, std::vector<int> values) {
+    bool changed = true;
+    while(changed) {
+        changed = false;
+        for(const Clause& clause : clauses) {
+            int free = 0, unit = 0;
+            bool satisfied = false;
+            for(Literal l : clause) {
+                int value = values[std::abs(l)] * (l > 0 ? 1 : -1);
+                satisfied = satisfied || value > 0;
+                if(value == 0) {
+                    free++;
+                    unit = l;
+                }
+            }
+            if(satisfied)
+                continue;
+            if(free == 0)
+                return false;
+            if(free == 1) {
+                values[std::abs(unit)] = unit > 0 ? 1 : -1;
+                changed = true;
+            }
+        }
+    }
+    for(const Clause& clause : clauses)
+        for(Literal l : clause)
+            if(values[std::abs(l)] == 0) {
+                values[std::abs(l)] = 1;
+                if(satisfiable(clauses, values))
+                    return true;
+                values[std::abs(l)] = -1;
+                return satisfiable(clauses, values);
+            }
+    return true;
+}
+
+enum Mode { AtMost, AtLeast, Exactly };
+
+template<typename Sink>
+EncodingSize encode(Sink& sink, int& atoms, const std::vector<Literal>& lits, Mode mode, int k,
+                    CardinalityEncoding::Encoding encoding) {
+    Cardinality<Sink> cardinality(sink, atoms);
+    switch(mode) {
+        case AtMost: return cardinality.atMost(lits, k, encoding);
+        case AtLeast: return cardinality.atLeast(lits, k, encoding);
+        default: return cardinality.exactly(lits, k, encoding);
+    }
+}
+
+// Za n <= 7, svako kodiranje i svaki nacin: valuacija ulaza se moze
+// prosiriti do modela klauza tacno kada zadovoljava ogranicenje, a
+// prijavljena velicina je broj zapisanih klauza i novih atoma.
+void bruteForce() {
+    const char* encodings[] = {"Auto", "Pairwise", "SequentialCounter", "Totalizer", "CardinalityNetwork"};
+    const char* modes[] = {"atMost", "atLeast", "exactly"};
+    for(int e = CardinalityEncoding::Auto; e <= CardinalityEncoding::CardinalityNetwork; e++)
+        for(Mode mode : {AtMost, AtLeast, Exactly}) {
+            std::string name = std::string("brute force n <= 7: ") + encodings[e] + ", " + modes[mode];
+            std::string error;
+            for(int n = 1; n <= 7 && error.empty(); n++)
+                for(int k = 0; k <= n && error.empty(); k++) {
+                    std::vector<Literal> lits(n);
+                    for(int i = 0; i < n; i++)
+                        lits[i] = i + 1;
+                    RecordingSink sink;
+                    int atoms = n;
+                    EncodingSize s = encode(sink, atoms, lits, mode, k, CardinalityEncoding::Encoding(e));
+                    std::string where = " (n = " + std::to_string(n) + ", k = " + std::to_string(k) + ")";
+                    if(s.atoms != atoms - n || s.clauses != (long long)sink.clauses.size()) {
+                        error = "velicina" + where;
+                        break;
+                    }
+                    for(int row = 0; row < 1 << n; row++) {
+                        std::vector<int> values(atoms + 1, 0);
+                        int count = 0;
+                        for(int i = 0; i < n; i++) {
+                            values[i + 1] = row >> i & 1 ? 1 : -1;
+                            count += row >> i & 1;
+                        }
+                        bool holds = mode == AtMost ? count <= k : mode == AtLeast ? count >= k : count == k;
+                        if(satisfiable(sink.clauses, values) != holds) {
+                            error = "valuacija " + std::to_string(row) + where;
+                            break;
+                        }
+                    }
+                }
+            check(error.empty(), name + (error.empty() ? "" : ": " + error));
+        }
+}
+
+// Za 0 < k < n <= 40 choose bira kodiranje sa najmanje klauza (pa atoma)
+// medju stvarno zapisanim velicinama; Pairwise se racuna kao C(n, k+1).
+// Za 0 < k < n <= 12 su i procene velicine brojaca, totalizatora i
+// Pairwise tacne.
+void chooseIsMinimal() {
+    std::string error, estimate;
+    for(int n = 2; n <= 40; n++)
+        for(int k = 1; k < n; k++) {
+            std::vector<Literal> lits(n);
+            for(int i = 0; i < n; i++)
+                lits[i] = i + 1;
+            EncodingSize sizes[5];
+            for(int e = CardinalityEncoding::SequentialCounter; e <= CardinalityEncoding::CardinalityNetwork; e++) {
+                CountingSink counting;
+                int atoms = n;
+                sizes[e] = encode(counting, atoms, lits, AtMost, k, CardinalityEncoding::Encoding(e));
+            }
+            sizes[CardinalityEncoding::Pairwise] = {0, CardinalityEncoding::binomial(n, k + 1, LLONG_MAX)};
+            if(n <= 12) {
+                CountingSink counting;
+                int atoms = n;
+                EncodingSize pairwise = encode(counting, atoms, lits, AtMost, k, CardinalityEncoding::Pairwise);
+                EncodingSize counter = CardinalityEncoding::sequentialCounterSize(n, k);
+                EncodingSize totalizer = CardinalityEncoding::totalizerSize(n, k);
+                auto same = [](EncodingSize a, EncodingSize b) { return a.atoms == b.atoms && a.clauses == b.clauses; };
+                if(estimate.empty() && (!same(pairwise, sizes[CardinalityEncoding::Pairwise])
+                   || !same(counter, sizes[CardinalityEncoding::SequentialCounter])
+                   || !same(totalizer, sizes[CardinalityEncoding::Totalizer])))
+                    estimate = "n = " + std::to_string(n) + ", k = " + std::to_string(k);
+            }
+            auto less = [](EncodingSize a, EncodingSize b) {
+                return std::tie(a.clauses, a.atoms) < std::tie(b.clauses, b.atoms);
+            };
+            EncodingSize best = sizes[CardinalityEncoding::Pairwise];
+            for(int e = CardinalityEncoding::SequentialCounter; e <= CardinalityEncoding::CardinalityNetwork; e++)
+                if(less(sizes[e], best))
+                    best = sizes[e];
+            EncodingSize chosen = sizes[CardinalityEncoding::choose(n, k)];
+            if(error.empty() && (less(best, chosen) || less(chosen, best)))
+                error = "n = " + std::to_string(n) + ", k = " + std::to_string(k);
+        }
+    check(estimate.empty(), "procene velicine" + (estimate.empty() ? "" : ": " + estimate));
+    check(error.empty(), "choose je najmanje kodiranje za n <= 40" + (error.empty() ? "" : ": " + error));
+}
+
+int main() {
+    closeToN();
+    bruteForce();
+    chooseIsMinimal();
+    return failures > 0;
+}